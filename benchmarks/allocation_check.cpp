@@ -0,0 +1,220 @@
+/// @file allocation_check.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Checks that the integration does not allocate: it replaces the
+/// global allocator with one which counts the allocations, and integrates a
+/// problem with a `std::vector` state through every stepper and driver, once
+/// they are sized. It also checks that the pull-based steps reproduce the
+/// schedule driver exactly. It exits with an error if any allocation is found
+/// where none is expected, or if the two differ.
+
+#include <numint/detail/observer.hpp>
+#include <numint/detail/trace.hpp>
+#include <numint/event.hpp>
+#include <numint/problems/brusselator_2d.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_euler.hpp>
+#include <numint/stepper/stepper_improved_euler.hpp>
+#include <numint/stepper/stepper_midpoint.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+#include <numint/stepper/stepper_simpsons.hpp>
+#include <numint/stepper/stepper_trapezoidal.hpp>
+#include <numint/steps.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace
+{
+
+/// The number of allocations made so far, by any thread.
+std::atomic<std::uint64_t> allocations{0};
+
+/// @brief Allocates memory, and counts the allocation.
+/// @param size The number of bytes.
+/// @return The memory.
+auto counted_allocate(std::size_t size) -> void *
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc((size > 0) ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+auto operator new(std::size_t size) -> void * { return counted_allocate(size); }
+
+auto operator new[](std::size_t size) -> void * { return counted_allocate(size); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace
+{
+
+/// The problem, whose state is a `std::vector`.
+using Problem = numint::problems::brusselator_2d;
+/// The state vector.
+using State   = Problem::state_type;
+/// The time is a continuous time value.
+using Time    = Problem::time_type;
+
+/// The adaptive steppers.
+template <class Stepper>
+using adaptive = numint::stepper_adaptive<Stepper, 2, numint::ErrorFormula::Mixed>;
+
+/// The number of failed checks.
+std::size_t failures = 0;
+
+/// @brief Counts the allocations made by a function.
+/// @param function The function.
+/// @return The number of allocations.
+template <class Function>
+auto count_allocations(Function &&function) -> std::uint64_t
+{
+    const std::uint64_t before = allocations.load(std::memory_order_relaxed);
+    function();
+    return allocations.load(std::memory_order_relaxed) - before;
+}
+
+/// @brief Reports a check, and records its failure.
+/// @param name The name of the check.
+/// @param count The number of allocations.
+/// @param expected The number of allocations expected.
+void report(const std::string &name, std::uint64_t count, std::uint64_t expected)
+{
+    const bool passed = (count == expected);
+    failures += passed ? 0 : 1;
+    std::cout << std::left << std::setw(56) << name << std::right << std::setw(8) << count << " allocation(s)"
+              << (passed ? "" : "  FAILED") << "\n";
+}
+
+/// @brief Reports a comparison, and records its failure.
+/// @param name The name of the comparison.
+/// @param identical If the two results are identical.
+void report_identical(const std::string &name, bool identical)
+{
+    failures += identical ? 0 : 1;
+    std::cout << std::left << std::setw(56) << name << std::right << std::setw(23)
+              << (identical ? "identical" : "different  FAILED") << "\n";
+}
+
+/// @brief Checks the steps and the drivers of a stepper.
+/// @param name The name of the stepper.
+template <class Stepper>
+void check(const std::string &name)
+{
+    const Problem problem;
+    const State initial = problem.initial_state();
+    const Time dt       = 1e-03;
+    State x             = initial;
+    Stepper stepper;
+    stepper.adjust_size(x);
+    // The steps, once the stepper is sized.
+    report(name + "/do_step", count_allocations([&]() {
+               for (unsigned i = 0; i < 100; ++i) {
+                   stepper.do_step(problem, x, static_cast<Time>(i) * dt, dt);
+               }
+           }),
+           0);
+    // The drivers, which size the stepper again, for the same state.
+    numint::detail::ObserverNull observer;
+    if constexpr (Stepper::is_adaptive_stepper) {
+        x = initial;
+        report(name + "/integrate_adaptive", count_allocations([&]() {
+                   numint::integrate_adaptive(stepper, observer, problem, x, 0., 2., dt);
+               }),
+               0);
+        const std::array<Time, 3> tstops{0.5, 1.1, 1.5};
+        x = initial;
+        report(name + "/integrate_adaptive (tstops)", count_allocations([&]() {
+                   numint::integrate_adaptive(stepper, observer, problem, x, 0., 2., dt, tstops);
+               }),
+               0);
+    } else {
+        x = initial;
+        report(name + "/integrate_fixed", count_allocations([&]() {
+                   numint::integrate_fixed(stepper, observer, problem, x, 0., 2., dt);
+               }),
+               0);
+    }
+    const std::array<numint::Breakpoint<Time, double>, 2> schedule{{{0.5, 1.}, {1.5, 2.}}};
+    x = initial;
+    report(name + "/integrate_schedule", count_allocations([&]() {
+               numint::integrate_schedule(
+                   stepper, observer, problem, x, 0., 2., dt, schedule, [](const auto &, State &) {});
+           }),
+           0);
+    x = initial;
+    report(name + "/steps", count_allocations([&]() {
+               for (const auto &step : numint::steps(stepper, problem, x, 0., 2., dt)) {
+                   (void)step;
+               }
+           }),
+           0);
+    // The steps land on the breakpoints like the schedule does, hence they
+    // must reach the same state, bit by bit.
+    State scheduled = initial;
+    numint::integrate_schedule(
+        stepper, observer, problem, scheduled, 0., 2., dt, schedule, [](const auto &, State &) {});
+    State pulled = initial;
+    {
+        auto range = numint::steps(stepper, problem, pulled, 0., 2., dt);
+        for (const auto &breakpoint : schedule) {
+            range.advance_to(breakpoint.time);
+        }
+        range.advance_to(2.);
+    }
+    report_identical(name + "/steps == integrate_schedule", scheduled == pulled);
+    // The event driver keeps two states aside, allocated once per call, hence
+    // the allocations must not grow with the number of steps.
+    const auto event = numint::make_event(
+        [](const State &state, Time) { return state[0] - 1e06; },
+        [](State &, Time) { return numint::EventAction::Continue; });
+    const auto integrate_events = [&](Time end_time) {
+        x = initial;
+        return count_allocations([&]() {
+            numint::integrate_events(stepper, observer, problem, x, 0., end_time, dt, 1e-09, event);
+        });
+    };
+    const std::uint64_t per_call = integrate_events(0.1);
+    report(name + "/integrate_events (loop)", integrate_events(2.) - per_call, 0);
+}
+
+} // namespace
+
+int main()
+{
+#ifdef NUMINT_TRACE
+    // The buffer of the timeline is allocated once, when the thread registers.
+    numint::detail::trace_reserve();
+#endif
+    check<numint::stepper_euler<State, Time>>("euler");
+    check<numint::stepper_improved_euler<State, Time>>("improved_euler");
+    check<numint::stepper_midpoint<State, Time>>("midpoint");
+    check<numint::stepper_trapezoidal<State, Time>>("trapezoidal");
+    check<numint::stepper_simpsons<State, Time>>("simpsons");
+    check<numint::stepper_rk4<State, Time>>("rk4");
+    check<adaptive<numint::stepper_euler<State, Time>>>("adaptive/euler");
+    check<adaptive<numint::stepper_improved_euler<State, Time>>>("adaptive/improved_euler");
+    check<adaptive<numint::stepper_midpoint<State, Time>>>("adaptive/midpoint");
+    check<adaptive<numint::stepper_trapezoidal<State, Time>>>("adaptive/trapezoidal");
+    check<adaptive<numint::stepper_simpsons<State, Time>>>("adaptive/simpsons");
+    check<adaptive<numint::stepper_rk4<State, Time>>>("adaptive/rk4");
+    std::cout << failures << " check(s) failed\n";
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,418 @@
+/// @file harness.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A minimal micro-benchmark harness: it calibrates the number of
+/// operations of a sample, takes repeated samples, keeps robust statistics of
+/// the time per operation, optionally reads the hardware counters, writes them
+/// as JSON, and compares two result files.
+
+#pragma once
+
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+/// @brief Prevents the compiler from optimizing away the computation of a value.
+/// @param value The value.
+template <class T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/// @brief The result of a benchmark.
+struct Result {
+    /// The name of the benchmark, e.g., "do_step/rk4/vector/1024".
+    std::string name;
+    /// The number of elements of the state, 0 if it does not apply.
+    std::size_t elements{};
+    /// The number of operations of each sample.
+    std::uint64_t iterations{};
+    /// The number of samples.
+    std::size_t samples{};
+    /// The median time of an operation, in nanoseconds.
+    double median_ns{};
+    /// The fastest time of an operation, in nanoseconds.
+    double min_ns{};
+    /// The slowest time of an operation, in nanoseconds.
+    double max_ns{};
+    /// The median absolute deviation of the time of an operation, in nanoseconds.
+    double mad_ns{};
+    /// The hardware counters of an operation (e.g., "cycles"), when they are read.
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+/// @brief The settings of a run.
+struct Options {
+    /// Only the benchmarks whose name contains this text run.
+    std::string filter;
+    /// The minimum duration of a sample, in seconds.
+    double min_time{0.01};
+    /// The number of samples.
+    std::size_t repeats{15};
+    /// The JSON file of the results, the standard output if empty.
+    std::string output;
+    /// Whether to read the hardware counters, in a separate run after the samples.
+    bool perf{false};
+    /// The configuration of a raw event of the CPU, counted as "fp_ops", 0 for none.
+    std::uint64_t perf_raw_event{};
+};
+
+/// @brief Runs the benchmarks, and gathers their results.
+class runner
+{
+public:
+    /// @brief Creates a runner.
+    /// @param options The settings of the run.
+    explicit runner(Options options)
+        : m_options(std::move(options))
+    {
+        if (m_options.perf) {
+            m_counters = std::make_unique<perf_counters>(m_options.perf_raw_event);
+            if (!m_counters->available()) {
+                std::cerr << "The hardware counters are not available, check perf_event_paranoid.\n";
+            }
+        }
+    }
+
+    /// @brief Runs a benchmark, unless it is filtered out.
+    /// @param name The name of the benchmark.
+    /// @param elements The number of elements of the state, 0 if it does not apply.
+    /// @param operation Function called as `operation(n)`, which performs n
+    /// operations; it may prepare its data before, which is amortized.
+    template <class Operation>
+    void run(const std::string &name, std::size_t elements, Operation &&operation)
+    {
+        if (name.find(m_options.filter) == std::string::npos) {
+            return;
+        }
+        // Warm up, and find how many operations take the minimum time.
+        std::uint64_t iterations = 1;
+        while (true) {
+            const double elapsed = runner::time(operation, iterations);
+            if ((elapsed >= m_options.min_time) || (iterations >= (std::uint64_t(1) << 40U))) {
+                break;
+            }
+            const double ratio = (elapsed > 0.) ? (m_options.min_time * 1.2 / elapsed) : 100.;
+            iterations         = static_cast<std::uint64_t>(
+                static_cast<double>(iterations) * std::min(std::max(ratio, 1.5), 100.));
+        }
+        // Take the samples.
+        std::vector<double> samples(std::max<std::size_t>(m_options.repeats, 1));
+        for (double &sample : samples) {
+            sample = runner::time(operation, iterations) * 1e09 / static_cast<double>(iterations);
+        }
+        Result result;
+        result.name       = name;
+        result.elements   = elements;
+        result.iterations = iterations;
+        result.samples    = samples.size();
+        result.median_ns  = median(samples);
+        result.min_ns     = *std::min_element(samples.begin(), samples.end());
+        result.max_ns     = *std::max_element(samples.begin(), samples.end());
+        for (double &sample : samples) {
+            sample = std::abs(sample - result.median_ns);
+        }
+        result.mad_ns = median(samples);
+        std::cerr << std::left << std::setw(48) << name << std::right << std::setw(14) << std::setprecision(4)
+                  << result.median_ns << " ns  +/- " << std::setw(8) << result.mad_ns << "\n";
+        // Count the events in a run of their own, so that the samples are not
+        // perturbed by the counters.
+        if (m_counters && m_counters->available()) {
+            m_counters->start();
+            operation(iterations);
+            m_counters->stop();
+            result.counters = m_counters->read();
+            std::cerr << std::setw(48) << "";
+            for (auto &[counter, value] : result.counters) {
+                value /= static_cast<double>(iterations);
+                std::cerr << "  " << counter << " " << value;
+                if (elements > 0) {
+                    std::cerr << " (" << (value / static_cast<double>(elements)) << "/el)";
+                }
+            }
+            std::cerr << "\n";
+        }
+        m_results.emplace_back(std::move(result));
+    }
+
+    /// @brief Returns the results gathered so far.
+    /// @return The results.
+    auto results() const -> const std::vector<Result> & { return m_results; }
+
+    /// @brief Writes the results as JSON, one benchmark per line.
+    /// @param out The output stream.
+    void write_json(std::ostream &out) const
+    {
+        out << "{\n\"context\": {\"compiler\": \"" << compiler() << "\", \"optimized\": "
+#ifdef NDEBUG
+            << "true"
+#else
+            << "false"
+#endif
+            << "},\n\"benchmarks\": [";
+        for (std::size_t i = 0; i < m_results.size(); ++i) {
+            const Result &result = m_results[i];
+            out << (i == 0 ? "\n" : ",\n") << std::setprecision(9) << "{\"name\": \"" << result.name
+                << "\", \"elements\": " << result.elements << ", \"iterations\": " << result.iterations
+                << ", \"samples\": " << result.samples << ", \"median_ns\": " << result.median_ns
+                << ", \"min_ns\": " << result.min_ns << ", \"max_ns\": " << result.max_ns
+                << ", \"mad_ns\": " << result.mad_ns;
+            if (!result.counters.empty()) {
+                runner::write_counters(out, "counters", result.counters, 1.);
+                if (result.elements > 0) {
+                    runner::write_counters(
+                        out, "counters_per_element", result.counters, 1. / static_cast<double>(result.elements));
+                }
+            }
+            out << "}";
+        }
+        out << "\n]\n}\n";
+    }
+
+    /// @brief Writes the results as JSON, to the output of the options.
+    void write_json() const
+    {
+        if (m_options.output.empty()) {
+            this->write_json(std::cout);
+            return;
+        }
+        std::ofstream out(m_options.output);
+        if (!out) {
+            throw std::runtime_error("Cannot create `" + m_options.output + "`.");
+        }
+        this->write_json(out);
+    }
+
+private:
+    /// @brief Writes the hardware counters of a result, as a JSON object.
+    /// @param out The output stream.
+    /// @param key The key of the object.
+    /// @param counters The counters, per operation.
+    /// @param scale The factor applied to the counters.
+    static void write_counters(
+        std::ostream &out,
+        const char *key,
+        const std::vector<std::pair<std::string, double>> &counters,
+        double scale)
+    {
+        out << ", \"" << key << "\": {";
+        for (std::size_t i = 0; i < counters.size(); ++i) {
+            out << (i == 0 ? "\"" : ", \"") << counters[i].first << "\": " << (counters[i].second * scale);
+        }
+        out << "}";
+    }
+
+    /// @brief Times a sample.
+    /// @param operation The operation.
+    /// @param iterations The number of operations.
+    /// @return The time, in seconds.
+    template <class Operation>
+    static auto time(Operation &operation, std::uint64_t iterations) -> double
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        operation(iterations);
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - begin).count();
+    }
+
+    /// @brief Computes the median of some values.
+    /// @param values The values, which are reordered.
+    /// @return The median.
+    static auto median(std::vector<double> &values) -> double
+    {
+        const std::size_t half = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(half), values.end());
+        if ((values.size() % 2) != 0) {
+            return values[half];
+        }
+        const double upper = values[half];
+        return (*std::max_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(half)) + upper) * 0.5;
+    }
+
+    /// @brief Describes the compiler.
+    /// @return The name and version of the compiler.
+    static auto compiler() -> std::string
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    /// The settings of the run.
+    Options m_options;
+    /// The hardware counters, when they are read.
+    std::unique_ptr<perf_counters> m_counters;
+    /// The results.
+    std::vector<Result> m_results;
+};
+
+/// @brief Reads the results written by `runner::write_json`.
+/// @param path The path of the file.
+/// @return The results, by name.
+inline auto read_json(const std::string &path) -> std::map<std::string, Result>
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open `" + path + "`.");
+    }
+    // Returns the text after `"key": `, in a line.
+    const auto field = [](const std::string &line, const std::string &key) -> std::string {
+        const std::string pattern = "\"" + key + "\": ";
+        std::size_t begin         = line.find(pattern);
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        begin += pattern.size();
+        if (line[begin] == '"') {
+            return line.substr(begin + 1, line.find('"', begin + 1) - begin - 1);
+        }
+        return line.substr(begin, line.find_first_of(",}", begin) - begin);
+    };
+    std::map<std::string, Result> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("{\"name\": ", 0) != 0) {
+            continue;
+        }
+        Result result;
+        result.name       = field(line, "name");
+        result.elements   = std::stoull(field(line, "elements"));
+        result.iterations = std::stoull(field(line, "iterations"));
+        result.samples    = std::stoull(field(line, "samples"));
+        result.median_ns  = std::stod(field(line, "median_ns"));
+        result.min_ns     = std::stod(field(line, "min_ns"));
+        result.max_ns     = std::stod(field(line, "max_ns"));
+        result.mad_ns     = std::stod(field(line, "mad_ns"));
+        results[result.name] = result;
+    }
+    return results;
+}
+
+/// @brief Compares two result files, and reports the regressions.
+///
+/// @details A benchmark regressed when both its median and its fastest time
+/// grew by more than the threshold, so that a noisy sample alone does not
+/// flag it.
+///
+/// @param baseline The path of the reference results.
+/// @param current The path of the new results.
+/// @param threshold The relative slowdown tolerated, e.g., 0.05 for 5%.
+/// @param out The output stream of the report.
+/// @return The number of regressions.
+inline auto compare(const std::string &baseline, const std::string &current, double threshold, std::ostream &out)
+    -> std::size_t
+{
+    const std::map<std::string, Result> before = read_json(baseline);
+    const std::map<std::string, Result> after  = read_json(current);
+    std::size_t regressions                    = 0;
+    out << std::left << std::setw(48) << "benchmark" << std::right << std::setw(14) << "baseline [ns]"
+        << std::setw(14) << "current [ns]" << std::setw(10) << "change" << "\n"
+        << std::setprecision(4);
+    for (const auto &[name, result] : after) {
+        const auto it = before.find(name);
+        if (it == before.end()) {
+            out << std::left << std::setw(48) << name << std::right << std::setw(14) << "-" << std::setw(14)
+                << result.median_ns << std::setw(10) << "new" << "\n";
+            continue;
+        }
+        const double change  = (result.median_ns / it->second.median_ns) - 1.;
+        const bool regressed = (change > threshold) && (result.min_ns > (it->second.min_ns * (1. + threshold)));
+        regressions += regressed ? 1 : 0;
+        out << std::left << std::setw(48) << name << std::right << std::setw(14) << it->second.median_ns
+            << std::setw(14) << result.median_ns << std::setw(9) << std::fixed << std::setprecision(1)
+            << (change * 100.) << "%" << std::defaultfloat << std::setprecision(4)
+            << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    for (const auto &[name, result] : before) {
+        if (after.find(name) == after.end()) {
+            out << std::left << std::setw(48) << name << std::right << std::setw(14) << result.median_ns
+                << std::setw(14) << "-" << std::setw(10) << "removed" << "\n";
+        }
+    }
+    out << regressions << " regression(s) above " << (threshold * 100.) << "%\n";
+    return regressions;
+}
+
+/// @brief Parses the command line shared by the benchmark tools.
+///
+/// @details The options are `--filter TEXT`, `--min-time SECONDS`,
+/// `--repeats N`, `--output FILE`, and `--perf` to read the hardware counters,
+/// with `--perf-raw HEX` for a raw event; `--compare BASELINE CURRENT` with an
+/// optional `--threshold PERCENT` compares two result files instead.
+///
+/// @param argc The number of arguments.
+/// @param argv The arguments.
+/// @param options The settings of the run.
+/// @param exit_code Set when the tool must exit instead of running, e.g., after a comparison.
+/// @return true if the benchmarks must run.
+inline auto parse_command_line(int argc, char **argv, Options &options, int &exit_code) -> bool
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string baseline, current;
+    double threshold = 5.;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const bool has_value = (i + 1) < args.size();
+        if ((args[i] == "--filter") && has_value) {
+            options.filter = args[++i];
+        } else if ((args[i] == "--min-time") && has_value) {
+            options.min_time = std::stod(args[++i]);
+        } else if ((args[i] == "--repeats") && has_value) {
+            options.repeats = std::stoul(args[++i]);
+        } else if ((args[i] == "--output") && has_value) {
+            options.output = args[++i];
+        } else if (args[i] == "--perf") {
+            options.perf = true;
+        } else if ((args[i] == "--perf-raw") && has_value) {
+            options.perf           = true;
+            options.perf_raw_event = std::stoull(args[++i], nullptr, 16);
+        } else if ((args[i] == "--threshold") && has_value) {
+            threshold = std::stod(args[++i]);
+        } else if ((args[i] == "--compare") && ((i + 2) < args.size())) {
+            baseline = args[++i];
+            current  = args[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter TEXT] [--min-time SECONDS] [--repeats N] [--output FILE] [--perf]\n"
+                      << "       [--perf-raw HEX]\n"
+                      << "       " << argv[0] << " --compare BASELINE CURRENT [--threshold PERCENT]\n";
+            exit_code = EXIT_FAILURE;
+            return false;
+        }
+    }
+    if (!baseline.empty()) {
+        exit_code = (compare(baseline, current, threshold / 100., std::cout) > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+        return false;
+    }
+    return true;
+}
+
+} // namespace bench
@@ -0,0 +1,500 @@
+/// @file numint_bench.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Micro-benchmarks of the steppers, the algebra, and the observers,
+/// whose results are written as JSON, and compared between two runs with
+/// `--compare BASELINE CURRENT` to spot regressions.
+
+#include "harness.hpp"
+
+#include <numint/detail/compression.hpp>
+#include <numint/detail/it_algebra.hpp>
+#include <numint/detail/observer.hpp>
+#include <numint/detail/text_writer.hpp>
+#include <numint/detail/trajectory.hpp>
+#include <numint/problems/arenstorf.hpp>
+#include <numint/problems/brusselator_2d.hpp>
+#include <numint/problems/hires.hpp>
+#include <numint/problems/lorenz.hpp>
+#include <numint/problems/n_body.hpp>
+#include <numint/problems/orego.hpp>
+#include <numint/problems/pleiades.hpp>
+#include <numint/problems/robertson.hpp>
+#include <numint/problems/van_der_pol.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_euler.hpp>
+#include <numint/stepper/stepper_improved_euler.hpp>
+#include <numint/stepper/stepper_midpoint.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+#include <numint/stepper/stepper_simpsons.hpp>
+#include <numint/stepper/stepper_trapezoidal.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <ratio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// The time is a continuous time value.
+using Time = double;
+
+/// @brief A system which rotates each pair of variables, cheap to evaluate,
+/// so that the benchmarks measure the library, and whose state stays bounded.
+struct Rotation {
+    template <class State>
+    void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        for (std::size_t i = 0; (i + 1) < x.size(); i += 2) {
+            dxdt[i]     = x[i + 1];
+            dxdt[i + 1] = -x[i];
+        }
+    }
+};
+
+/// @brief Sets the initial state.
+/// @param x The state, resized if possible.
+/// @param n The number of elements.
+template <class State>
+void initialize(State &x, std::size_t n)
+{
+    if constexpr (numint::detail::has_resize_v<State>) {
+        x.resize(n);
+    }
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = 1. / static_cast<double>(1 + (i % 7));
+    }
+}
+
+/// @brief Names the container of a state.
+/// @return "array" or "vector".
+template <class State>
+auto container_name() -> std::string
+{
+    return numint::detail::has_resize_v<State> ? "vector" : "array";
+}
+
+/// @brief Benchmarks one step of a stepper.
+/// @param runner The runner.
+/// @param name The name of the stepper.
+/// @param n The number of elements of the state.
+template <class Stepper>
+void bench_do_step(bench::runner &runner, const std::string &name, std::size_t n)
+{
+    using State = typename Stepper::state_type;
+    Rotation system;
+    Stepper stepper;
+    State x{};
+    initialize(x, n);
+    if constexpr (numint::detail::has_resize_v<State>) {
+        stepper.adjust_size(x);
+    }
+    runner.run("do_step/" + name + "/" + container_name<State>() + "/" + std::to_string(n), n, [&](std::uint64_t count) {
+        initialize(x, n);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            stepper.do_step(system, x, 0., 1e-03);
+        }
+        bench::do_not_optimize(x);
+    });
+}
+
+/// @brief Benchmarks one step of every stepper, on a state.
+/// @param runner The runner.
+/// @param n The number of elements of the state.
+template <class State>
+void bench_steppers(bench::runner &runner, std::size_t n)
+{
+    bench_do_step<numint::stepper_euler<State, Time>>(runner, "euler", n);
+    bench_do_step<numint::stepper_improved_euler<State, Time>>(runner, "improved_euler", n);
+    bench_do_step<numint::stepper_midpoint<State, Time>>(runner, "midpoint", n);
+    bench_do_step<numint::stepper_trapezoidal<State, Time>>(runner, "trapezoidal", n);
+    bench_do_step<numint::stepper_simpsons<State, Time>>(runner, "simpsons", n);
+    bench_do_step<numint::stepper_rk4<State, Time>>(runner, "rk4", n);
+}
+
+/// @brief Benchmarks the kernels of the algebra, on a state.
+/// @param runner The runner.
+/// @param n The number of elements of the state.
+template <class State>
+void bench_algebra(bench::runner &runner, std::size_t n)
+{
+    namespace algebra = numint::detail::it_algebra;
+    State y{}, a{}, b{}, c{}, d{};
+    initialize(y, n), initialize(a, n), initialize(b, n), initialize(c, n), initialize(d, n);
+    const std::string suffix = "/" + container_name<State>() + "/" + std::to_string(n);
+    runner.run("algebra/sum_operation_1" + suffix, n, [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            algebra::sum_operation(y, std::multiplies<>(), 1.0, a, 0.5, b);
+            bench::do_not_optimize(y);
+        }
+    });
+    runner.run("algebra/sum_operation_4" + suffix, n, [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            algebra::sum_operation(y, std::multiplies<>(), 1.0, a, 0.1, b, 0.2, c, 0.2, d, 0.1, y);
+            bench::do_not_optimize(y);
+        }
+    });
+    runner.run("algebra/accumulate_operation" + suffix, n, [&](std::uint64_t count) {
+        initialize(y, n);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            algebra::accumulate_operation(y, std::multiplies<>(), 1e-09, a, -1e-09, b);
+            bench::do_not_optimize(y);
+        }
+    });
+    runner.run("algebra/max_abs_diff" + suffix, n, [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(algebra::max_abs_diff<double>(a, b));
+        }
+    });
+    runner.run("algebra/max_rel_diff" + suffix, n, [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(algebra::max_rel_diff<double>(a, b));
+        }
+    });
+    runner.run("algebra/max_comb_diff" + suffix, n, [&](std::uint64_t count) {
+        for (std::uint64_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(algebra::max_comb_diff<double>(a, b));
+        }
+    });
+}
+
+/// @brief Benchmarks one step of the adaptive stepper, on a state.
+/// @param runner The runner.
+/// @param inner The name of the stepper it wraps.
+/// @param name The name of the error formula.
+/// @param n The number of elements of the state.
+template <class Inner, int Iterations, numint::ErrorFormula Error, class State>
+void bench_adaptive(bench::runner &runner, const std::string &inner, const std::string &name, std::size_t n)
+{
+    using Stepper = numint::stepper_adaptive<Inner, Iterations, Error>;
+    Rotation system;
+    Stepper stepper;
+    stepper.set_tollerance(1e-06);
+    State x{};
+    initialize(x, n);
+    if constexpr (numint::detail::has_resize_v<State>) {
+        stepper.adjust_size(x);
+    }
+    runner.run(
+        "adaptive/" + inner + "/" + std::to_string(Iterations) + "/" + name + "/" + container_name<State>() + "/" +
+            std::to_string(n),
+        n, [&](std::uint64_t count) {
+            initialize(x, n);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                stepper.do_step(system, x, 0., 1e-03);
+            }
+            bench::do_not_optimize(x);
+        });
+}
+
+/// @brief Benchmarks one step of the adaptive stepper: around rk4 for every
+/// error formula, and around the other steppers for the absolute one, as the
+/// formula does not depend on the stepper.
+/// @param runner The runner.
+/// @param n The number of elements of the state.
+template <int Iterations, class State>
+void bench_adaptive(bench::runner &runner, std::size_t n)
+{
+    using numint::ErrorFormula;
+    bench_adaptive<numint::stepper_rk4<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "rk4", "absolute", n);
+    bench_adaptive<numint::stepper_rk4<State, Time>, Iterations, ErrorFormula::Relative, State>(
+        runner, "rk4", "relative", n);
+    bench_adaptive<numint::stepper_rk4<State, Time>, Iterations, ErrorFormula::Mixed, State>(runner, "rk4", "mixed", n);
+    bench_adaptive<numint::stepper_euler<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "euler", "absolute", n);
+    bench_adaptive<numint::stepper_improved_euler<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "improved_euler", "absolute", n);
+    bench_adaptive<numint::stepper_midpoint<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "midpoint", "absolute", n);
+    bench_adaptive<numint::stepper_trapezoidal<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "trapezoidal", "absolute", n);
+    bench_adaptive<numint::stepper_simpsons<State, Time>, Iterations, ErrorFormula::Absolute, State>(
+        runner, "simpsons", "absolute", n);
+}
+
+/// @brief Benchmarks one step of a stepper on a test problem, from its initial
+/// state, with a step small enough to be stable on the stiff ones.
+/// @param runner The runner.
+/// @param name The name of the stepper.
+/// @param problem The problem.
+/// @param label The label of the problem.
+template <class Stepper, class Problem>
+void bench_problem_step(bench::runner &runner, const std::string &name, const Problem &problem, const std::string &label)
+{
+    using State = typename Stepper::state_type;
+    const Time dt = (Problem::end_time - Problem::start_time) * 1e-09;
+    const State x0 = problem.initial_state();
+    Stepper stepper;
+    State x = x0;
+    if constexpr (numint::detail::has_resize_v<State>) {
+        stepper.adjust_size(x);
+    }
+    runner.run("problem/" + label + "/" + name, x0.size(), [&](std::uint64_t count) {
+        x = x0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            stepper.do_step(problem, x, Problem::start_time, dt);
+        }
+        bench::do_not_optimize(x);
+    });
+}
+
+/// @brief Benchmarks one step of every stepper on a test problem.
+/// @param runner The runner.
+/// @param problem The problem.
+/// @param label The label of the problem.
+template <class Problem>
+void bench_problem(bench::runner &runner, const Problem &problem, const std::string &label)
+{
+    using State = typename Problem::state_type;
+    bench_problem_step<numint::stepper_euler<State, Time>>(runner, "euler", problem, label);
+    bench_problem_step<numint::stepper_improved_euler<State, Time>>(runner, "improved_euler", problem, label);
+    bench_problem_step<numint::stepper_midpoint<State, Time>>(runner, "midpoint", problem, label);
+    bench_problem_step<numint::stepper_trapezoidal<State, Time>>(runner, "trapezoidal", problem, label);
+    bench_problem_step<numint::stepper_simpsons<State, Time>>(runner, "simpsons", problem, label);
+    bench_problem_step<numint::stepper_rk4<State, Time>>(runner, "rk4", problem, label);
+}
+
+/// @brief An observer which keeps the last time, through the base class.
+struct ObserverLast : public numint::detail::ObserverDecimate<std::array<double, 2>, Time, 0> {
+    void operator()(const std::array<double, 2> &x, const Time &t) noexcept
+    {
+        if (this->observe()) {
+            last = t + x[0];
+        }
+    }
+    Time last{};
+};
+
+/// @brief An observer which keeps the last time, sampled every 10 ms, i.e.,
+/// every 10 steps of the benchmark.
+struct ObserverSampled : public numint::detail::ObserverSample<std::array<double, 2>, Time, std::centi> {
+    void operator()(const std::array<double, 2> &x, const Time &t) noexcept
+    {
+        if (this->observe(t)) {
+            last = t + x[0];
+        }
+    }
+    Time last{};
+};
+
+/// @brief Benchmarks a fixed-step integration with an observer, whose cost
+/// is the difference with `ObserverNull`.
+/// @param runner The runner.
+/// @param name The name of the observer.
+/// @param observer The observer.
+template <class Observer>
+void bench_observer(bench::runner &runner, const std::string &name, Observer &&observer)
+{
+    using State = std::array<double, 2>;
+    Rotation system;
+    numint::stepper_euler<State, Time> stepper;
+    State x{};
+    runner.run("observer/" + name, 2, [&](std::uint64_t count) {
+        initialize(x, 2);
+        numint::integrate_fixed(stepper, observer, system, x, 0., static_cast<Time>(count) * 1e-03, 1e-03);
+        bench::do_not_optimize(x);
+    });
+}
+
+/// @brief Returns the path of a scratch file of the benchmarks.
+/// @param name The name of the file.
+/// @return The path, in the temporary directory.
+auto scratch_path(const std::string &name) -> std::string
+{
+    return (std::filesystem::temp_directory_path() / ("numint_bench_" + name)).string();
+}
+
+/// @brief Benchmarks a fixed-step integration with an observer writing the
+/// trajectory, created for each run, so that the output does not pile up.
+/// @param runner The runner.
+/// @param name The name of the observer.
+/// @param make Function returning a new observer.
+template <class Make>
+void bench_writer(bench::runner &runner, const std::string &name, Make &&make)
+{
+    using State = std::array<double, 2>;
+    Rotation system;
+    numint::stepper_euler<State, Time> stepper;
+    State x{};
+    runner.run("observer/" + name, 2, [&](std::uint64_t count) {
+        initialize(x, 2);
+        auto observer = make();
+        numint::integrate_fixed(stepper, observer, system, x, 0., static_cast<Time>(count) * 1e-03, 1e-03);
+        bench::do_not_optimize(x);
+    });
+}
+
+/// @brief Benchmarks reading back a trajectory file, one column at a time.
+/// @param runner The runner.
+/// @param rows The number of rows of the file.
+void bench_trajectory_reader(bench::runner &runner, std::size_t rows)
+{
+    using State             = std::array<double, 2>;
+    const std::string path  = scratch_path("read.traj");
+    {
+        Rotation system;
+        numint::stepper_euler<State, Time> stepper;
+        numint::detail::ObserverTrajectory<State, Time> observer(path, {"x", "v"});
+        State x{};
+        initialize(x, 2);
+        numint::integrate_fixed(stepper, observer, system, x, 0., static_cast<Time>(rows - 1) * 1e-03, 1e-03);
+    }
+    {
+        const numint::detail::trajectory_reader<double, Time> reader(path);
+        runner.run("reader/trajectory/" + std::to_string(reader.size()), reader.size(), [&](std::uint64_t count) {
+            double sum = 0.;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                for (std::size_t column = 0; column < reader.columns(); ++column) {
+                    const auto values = reader.column(column);
+                    for (std::size_t row = 0; row < values.size(); ++row) {
+                        sum += values[row];
+                    }
+                }
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+    std::remove(path.c_str());
+}
+
+/// @brief Benchmarks decoding a compressed trajectory, as a whole.
+/// @param runner The runner.
+/// @param rows The number of rows of the trajectory.
+void bench_trajectory_decoder(bench::runner &runner, std::size_t rows)
+{
+    using State = std::array<double, 2>;
+    std::vector<unsigned char> stream;
+    {
+        Rotation system;
+        numint::stepper_euler<State, Time> stepper;
+        numint::detail::ObserverCompress<State, Time> observer(
+            [&stream](const unsigned char *data, std::size_t size) { stream.insert(stream.end(), data, data + size); });
+        State x{};
+        initialize(x, 2);
+        numint::integrate_fixed(stepper, observer, system, x, 0., static_cast<Time>(rows - 1) * 1e-03, 1e-03);
+    }
+    runner.run("reader/compressed/" + std::to_string(rows), rows, [&](std::uint64_t count) {
+        State x{};
+        Time t{};
+        double sum = 0.;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            numint::detail::trajectory_decoder<double, Time> decoder;
+            decoder.feed(stream.data(), stream.size());
+            while (decoder.next(x, t)) {
+                sum += x[0] + x[1];
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bench::Options options;
+    int exit_code = EXIT_SUCCESS;
+    try {
+        if (!bench::parse_command_line(argc, argv, options, exit_code)) {
+            return exit_code;
+        }
+        bench::runner runner(options);
+
+        // One step of every stepper, on states of growing size.
+        bench_steppers<std::array<double, 2>>(runner, 2);
+        bench_steppers<std::array<double, 16>>(runner, 16);
+        bench_steppers<std::array<double, 256>>(runner, 256);
+        for (std::size_t n : {2UL, 16UL, 256UL, 4096UL, 65536UL, 1000000UL}) {
+            bench_steppers<std::vector<double>>(runner, n);
+        }
+
+        // The kernels of the algebra.
+        bench_algebra<std::array<double, 16>>(runner, 16);
+        bench_algebra<std::array<double, 256>>(runner, 256);
+        for (std::size_t n : {16UL, 4096UL, 1000000UL}) {
+            bench_algebra<std::vector<double>>(runner, n);
+        }
+
+        // The adaptive stepper, which checks each step against the same step
+        // taken in two halves (2 iterations) or in four quarters (4 iterations).
+        for (std::size_t n : {16UL, 65536UL}) {
+            bench_adaptive<2, std::vector<double>>(runner, n);
+            bench_adaptive<4, std::vector<double>>(runner, n);
+        }
+        bench_adaptive<2, std::array<double, 16>>(runner, 16);
+        bench_adaptive<4, std::array<double, 16>>(runner, 16);
+
+        // The standard test problems.
+        bench_problem(runner, numint::problems::lorenz(), "lorenz");
+        bench_problem(runner, numint::problems::arenstorf(), "arenstorf");
+        bench_problem(runner, numint::problems::pleiades(), "pleiades");
+        bench_problem(runner, numint::problems::outer_solar_system(), "outer_solar_system");
+        bench_problem(runner, numint::problems::robertson(), "robertson");
+        bench_problem(runner, numint::problems::van_der_pol(), "van_der_pol");
+        bench_problem(runner, numint::problems::hires(), "hires");
+        bench_problem(runner, numint::problems::orego(), "orego");
+        bench_problem(runner, numint::problems::brusselator_2d(8), "brusselator_2d/8");
+        bench_problem(runner, numint::problems::brusselator_2d(128), "brusselator_2d/128");
+
+        // The dispatch of the observer, per step.
+        double sink = 0.;
+        bench_observer(runner, "null", numint::detail::ObserverNull());
+        bench_observer(runner, "lambda", [&sink](const std::array<double, 2> &x, const Time &t) { sink = t + x[0]; });
+        bench_observer(runner, "decimate", ObserverLast());
+        bench_observer(runner, "sample", ObserverSampled());
+        bench_observer(
+            runner, "std_function",
+            std::function<void(const std::array<double, 2> &, const Time &)>(
+                [&sink](const std::array<double, 2> &x, const Time &t) { sink = t + x[0]; }));
+        bench::do_not_optimize(sink);
+
+        // The observers writing the trajectory to a file, and reading it back.
+        const std::string trajectory = scratch_path("write.traj");
+        bench_writer(runner, "trajectory", [&trajectory]() {
+            return numint::detail::ObserverTrajectory<std::array<double, 2>, Time>(trajectory, {"x", "v"});
+        });
+        std::remove(trajectory.c_str());
+        bench_trajectory_reader(runner, 65536);
+
+        // The compression of the trajectory, lossless and lossy, and its decoding.
+        std::size_t compressed = 0;
+        const auto count_bytes = [&compressed](const unsigned char *, std::size_t size) { compressed += size; };
+        bench_writer(runner, "compress", [&count_bytes]() {
+            return numint::detail::ObserverCompress<std::array<double, 2>, Time>(count_bytes);
+        });
+        bench_writer(runner, "compress_lossy", [&count_bytes]() {
+            return numint::detail::ObserverCompress<std::array<double, 2>, Time>(
+                count_bytes, std::vector<double>{1e-06, 1e-06});
+        });
+        bench::do_not_optimize(compressed);
+        bench_trajectory_decoder(runner, 65536);
+
+        // The observer writing the trajectory as text, shortest and fixed precision.
+        const std::string text = scratch_path("write.csv");
+        bench_writer(runner, "text", [&text]() {
+            return numint::detail::ObserverText<std::array<double, 2>, Time>(text, {"x", "v"});
+        });
+        bench_writer(runner, "text_fixed", [&text]() {
+            return numint::detail::ObserverText<std::array<double, 2>, Time>(
+                text, {"x", "v"}, ',', 6, std::chars_format::fixed);
+        });
+        std::remove(text.c_str());
+
+        runner.write_json();
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return exit_code;
+}
@@ -0,0 +1,159 @@
+/// @file perf_counters.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Hardware performance counters, read through `perf_event_open` on
+/// Linux: the cycles, the instructions, the L1 data and last-level cache
+/// misses, the branch misses, and optionally a raw event such as the vector
+/// floating point operations, counted in user space around a region.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench
+{
+
+/// @brief A set of hardware counters, counting the current thread in user
+/// space. Each counter is opened on its own, so that the ones the CPU or the
+/// kernel does not provide (e.g., in a virtual machine, or when
+/// `/proc/sys/kernel/perf_event_paranoid` forbids them) are simply missing,
+/// and the counts are scaled when the kernel had to multiplex them.
+class perf_counters
+{
+public:
+    /// @brief Opens the counters.
+    /// @param raw_event The configuration of a raw event of the CPU, counted as
+    /// "fp_ops", 0 for none (e.g., 0x3cc7 counts the packed floating point
+    /// operations retired on recent Intel CPUs, FP_ARITH_INST_RETIRED).
+    explicit perf_counters(std::uint64_t raw_event = 0)
+    {
+#if defined(__linux__)
+        this->open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        this->open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        this->open(
+            "l1d_misses", PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U));
+        this->open("llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        this->open("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        if (raw_event != 0) {
+            this->open("fp_ops", PERF_TYPE_RAW, raw_event);
+        }
+#else
+        (void)raw_event;
+#endif
+    }
+
+    /// @brief Closes the counters.
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for (const counter &entry : m_counters) {
+            ::close(entry.fd);
+        }
+#endif
+    }
+
+    /// @brief Copy constructor.
+    perf_counters(const perf_counters &other) = delete;
+
+    /// @brief Copy assignment operator.
+    /// @return Reference to the counters.
+    auto operator=(const perf_counters &other) -> perf_counters & = delete;
+
+    /// @brief Checks if any counter is available.
+    /// @return true if at least one counter could be opened.
+    auto available() const noexcept -> bool { return !m_counters.empty(); }
+
+    /// @brief Resets the counters, and starts counting.
+    void start() noexcept
+    {
+#if defined(__linux__)
+        for (const counter &entry : m_counters) {
+            ::ioctl(entry.fd, PERF_EVENT_IOC_RESET, 0);
+        }
+        for (const counter &entry : m_counters) {
+            ::ioctl(entry.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// @brief Stops counting.
+    void stop() noexcept
+    {
+#if defined(__linux__)
+        for (const counter &entry : m_counters) {
+            ::ioctl(entry.fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+    }
+
+    /// @brief Reads the counts, since the last start.
+    /// @return The name and the count of each available counter.
+    auto read() const -> std::vector<std::pair<std::string, double>>
+    {
+        std::vector<std::pair<std::string, double>> counts;
+#if defined(__linux__)
+        for (const counter &entry : m_counters) {
+            // The value, the time enabled, and the time running.
+            std::uint64_t values[3] = {0, 0, 0};
+            if (::read(entry.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+                continue;
+            }
+            double count = static_cast<double>(values[0]);
+            if ((values[2] > 0) && (values[2] < values[1])) {
+                count *= static_cast<double>(values[1]) / static_cast<double>(values[2]);
+            }
+            counts.emplace_back(entry.name, count);
+        }
+#endif
+        return counts;
+    }
+
+private:
+    /// @brief An open counter.
+    struct counter {
+        /// The name of the counter.
+        const char *name;
+        /// The file descriptor of the counter.
+        int fd;
+    };
+
+#if defined(__linux__)
+    /// @brief Opens a counter, which starts disabled.
+    /// @param name The name of the counter.
+    /// @param type The type of the event.
+    /// @param config The configuration of the event.
+    void open(const char *name, std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const long fd       = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fd >= 0) {
+            m_counters.push_back(counter{name, static_cast<int>(fd)});
+        }
+    }
+#endif
+
+    /// The open counters.
+    std::vector<counter> m_counters;
+};
+
+} // namespace bench
@@ -0,0 +1,450 @@
+/// @file work_precision.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Generates the work-precision diagrams of the steppers: it sweeps the
+/// time step of the fixed steppers and the tolerance of the adaptive ones on
+/// the test problems, and measures the error at the end time against the
+/// reference, the evaluations of the system, and the wall time, repeated to
+/// give a confidence interval. The points are written as CSV or JSON, ready
+/// to be plotted.
+
+#include "harness.hpp"
+
+#include <numint/detail/observer.hpp>
+#include <numint/problems/arenstorf.hpp>
+#include <numint/problems/brusselator_2d.hpp>
+#include <numint/problems/hires.hpp>
+#include <numint/problems/lorenz.hpp>
+#include <numint/problems/n_body.hpp>
+#include <numint/problems/orego.hpp>
+#include <numint/problems/pleiades.hpp>
+#include <numint/problems/robertson.hpp>
+#include <numint/problems/van_der_pol.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_euler.hpp>
+#include <numint/stepper/stepper_improved_euler.hpp>
+#include <numint/stepper/stepper_midpoint.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+#include <numint/stepper/stepper_simpsons.hpp>
+#include <numint/stepper/stepper_trapezoidal.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// The time is a continuous time value.
+using Time = double;
+
+/// The adaptive steppers, which control the mixed error of two half steps.
+template <class Stepper>
+using adaptive = numint::stepper_adaptive<Stepper, 2, numint::ErrorFormula::Mixed>;
+
+/// @brief The settings of the sweep.
+struct Options {
+    /// Only the points whose name ("problem/mode/stepper") contains this text run.
+    std::string filter;
+    /// The number of timed runs of each point.
+    std::size_t repeats{5};
+    /// The fewest steps of the fixed steppers.
+    std::uint64_t min_steps{16};
+    /// The most steps of any run, longer runs are reported as not completed.
+    std::uint64_t max_steps{1U << 16U};
+    /// The loosest tolerance of the adaptive steppers.
+    double max_tolerance{1e-02};
+    /// The tightest tolerance of the adaptive steppers.
+    double min_tolerance{1e-10};
+    /// The CSV file of the points, the standard output if both files are empty.
+    std::string csv;
+    /// The JSON file of the points.
+    std::string json;
+};
+
+/// @brief A point of a work-precision diagram.
+struct Point {
+    /// The name of the problem.
+    std::string problem;
+    /// Either "fixed" or "adaptive".
+    std::string mode;
+    /// The name of the stepper.
+    std::string stepper;
+    /// The time step of a fixed stepper, or the tolerance of an adaptive one.
+    double setting{};
+    /// Whether the run reached the end time within the maximum number of steps.
+    bool completed{};
+    /// The number of steps.
+    std::uint64_t steps{};
+    /// The number of evaluations of the system.
+    std::uint64_t evaluations{};
+    /// The error at the end time, relative to the largest element of the reference.
+    double error{};
+    /// The number of timed runs.
+    std::size_t samples{};
+    /// The mean wall time of a run, in seconds.
+    double mean_s{};
+    /// The half-width of the 95% confidence interval of the mean, in seconds.
+    double ci95_s{};
+    /// The fastest run, in seconds.
+    double min_s{};
+};
+
+/// @brief Wraps a problem, and counts the evaluations of the system.
+template <class Problem>
+struct counted_problem {
+    /// @brief Evaluates the problem.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State>
+    void operator()(const State &x, State &dxdt, Time t) noexcept
+    {
+        ++evaluations;
+        problem(x, dxdt, t);
+    }
+
+    /// The problem.
+    const Problem &problem;
+    /// The number of evaluations.
+    std::uint64_t evaluations;
+};
+
+/// @brief Computes the error of a state against the reference, as the largest
+/// difference relative to the largest element of the reference.
+/// @param x The state.
+/// @param reference The reference.
+/// @return The error, NaN if the state is not finite.
+template <class State>
+auto error_of(const State &x, const State &reference) -> double
+{
+    double difference = 0., scale = 0.;
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        if (!std::isfinite(x[i])) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        difference = std::max(difference, std::abs(x[i] - reference[i]));
+        scale      = std::max(scale, std::abs(reference[i]));
+    }
+    return difference / std::max(scale, std::numeric_limits<double>::min());
+}
+
+/// @brief Returns the 97.5% quantile of the Student's t distribution.
+/// @param dof The degrees of freedom.
+/// @return The quantile.
+auto student_t975(std::size_t dof) -> double
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (dof == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return (dof <= 30) ? table[dof - 1] : 1.96;
+}
+
+/// @brief Times the runs of a point, and fills in its timing.
+/// @param point The point.
+/// @param repeats The number of runs.
+/// @param run Function performing one run.
+template <class Run>
+void time_runs(Point &point, std::size_t repeats, Run &&run)
+{
+    std::vector<double> samples(std::max<std::size_t>(repeats, 1));
+    for (double &sample : samples) {
+        const auto begin = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        sample         = std::chrono::duration<double>(end - begin).count();
+    }
+    double sum = 0., squares = 0.;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    point.samples = samples.size();
+    point.mean_s  = sum / static_cast<double>(samples.size());
+    for (double sample : samples) {
+        squares += (sample - point.mean_s) * (sample - point.mean_s);
+    }
+    const double n = static_cast<double>(samples.size());
+    point.ci95_s   = (samples.size() > 1) ? student_t975(samples.size() - 1) * std::sqrt(squares / (n - 1.) / n) : 0.;
+    point.min_s    = *std::min_element(samples.begin(), samples.end());
+}
+
+/// @brief Prints the progress of the sweep.
+/// @param point The point just measured.
+void print(const Point &point)
+{
+    std::cerr << std::left << std::setw(40) << (point.problem + "/" + point.mode + "/" + point.stepper) << std::right
+              << std::setprecision(3) << std::setw(10) << point.setting << std::setw(10) << point.steps
+              << " steps, error " << std::setw(10) << point.error << ", " << std::setw(10) << point.mean_s
+              << " s +/- " << point.ci95_s << (point.completed ? "" : " (not completed)") << "\n";
+}
+
+/// @brief Sweeps the time step of a fixed stepper on a problem, halving it
+/// from `min_steps` to `max_steps` steps over the time span.
+/// @param points The points of the diagram.
+/// @param options The settings of the sweep.
+/// @param problem The problem.
+/// @param name The name of the stepper.
+template <class Stepper, class Problem>
+void sweep_fixed(std::vector<Point> &points, const Options &options, const Problem &problem, const std::string &name)
+{
+    using State = typename Problem::state_type;
+    if ((std::string(Problem::name) + "/fixed/" + name).find(options.filter) == std::string::npos) {
+        return;
+    }
+    const State initial   = problem.initial_state();
+    const State reference = problem.reference();
+    const Time span       = Problem::end_time - Problem::start_time;
+    // The steps are taken at exact multiples of the time step, so that the
+    // last one ends at the end time, rather than accumulating the time.
+    const auto integrate = [&](auto &&system, State &x, std::uint64_t steps) {
+        Stepper stepper;
+        if constexpr (numint::detail::has_resize_v<State>) {
+            stepper.adjust_size(x);
+        }
+        const Time dt = span / static_cast<Time>(steps);
+        for (std::uint64_t i = 0; i < steps; ++i) {
+            stepper.do_step(system, x, Problem::start_time + (static_cast<Time>(i) * dt), dt);
+        }
+    };
+    for (std::uint64_t steps = options.min_steps; steps <= options.max_steps; steps *= 2) {
+        Point point;
+        point.problem   = Problem::name;
+        point.mode      = "fixed";
+        point.stepper   = name;
+        point.setting   = span / static_cast<Time>(steps);
+        point.completed = true;
+        point.steps     = steps;
+        // The first run counts the evaluations, and measures the error.
+        counted_problem<Problem> counted{problem, 0};
+        State x = initial;
+        integrate(counted, x, steps);
+        point.evaluations = counted.evaluations;
+        point.error       = error_of(x, reference);
+        time_runs(point, options.repeats, [&]() {
+            State y = initial;
+            integrate(problem, y, steps);
+            bench::do_not_optimize(y);
+        });
+        print(point);
+        points.emplace_back(std::move(point));
+    }
+}
+
+/// @brief Sweeps the tolerance of an adaptive stepper on a problem, dividing
+/// it by 10 from `max_tolerance` to `min_tolerance`.
+/// @param points The points of the diagram.
+/// @param options The settings of the sweep.
+/// @param problem The problem.
+/// @param name The name of the stepper.
+template <class Stepper, class Problem>
+void sweep_adaptive(std::vector<Point> &points, const Options &options, const Problem &problem, const std::string &name)
+{
+    using State = typename Problem::state_type;
+    if ((std::string(Problem::name) + "/adaptive/" + name).find(options.filter) == std::string::npos) {
+        return;
+    }
+    const State initial   = problem.initial_state();
+    const State reference = problem.reference();
+    const Time span       = Problem::end_time - Problem::start_time;
+    // Returns the number of steps, which exceeds the maximum if the run was stopped.
+    const auto integrate = [&](auto &&system, State &x, double tolerance) -> std::uint64_t {
+        Stepper stepper;
+        stepper.set_tollerance(tolerance);
+        stepper.set_max_delta(span);
+        std::uint64_t steps = 0;
+        numint::integrate_adaptive(
+            stepper, numint::detail::ObserverNull(), system, x, Problem::start_time, Problem::end_time,
+            span * 1e-06, [&](const State &) { return ++steps > options.max_steps; });
+        return steps;
+    };
+    for (double tolerance = options.max_tolerance; tolerance >= (options.min_tolerance * 0.99); tolerance *= 0.1) {
+        Point point;
+        point.problem = Problem::name;
+        point.mode    = "adaptive";
+        point.stepper = name;
+        point.setting = tolerance;
+        // The first run counts the evaluations, and measures the error.
+        counted_problem<Problem> counted{problem, 0};
+        State x           = initial;
+        point.steps       = integrate(counted, x, tolerance);
+        point.completed   = point.steps <= options.max_steps;
+        point.evaluations = counted.evaluations;
+        point.error       = point.completed ? error_of(x, reference) : std::numeric_limits<double>::quiet_NaN();
+        // Runs which did not complete are not timed, as they are meaningless.
+        if (point.completed) {
+            time_runs(point, options.repeats, [&]() {
+                State y = initial;
+                bench::do_not_optimize(integrate(problem, y, tolerance));
+                bench::do_not_optimize(y);
+            });
+        }
+        print(point);
+        points.emplace_back(std::move(point));
+    }
+}
+
+/// @brief Sweeps every stepper, fixed and adaptive, on a problem.
+/// @param points The points of the diagram.
+/// @param options The settings of the sweep.
+/// @param problem The problem.
+template <class Problem>
+void sweep(std::vector<Point> &points, const Options &options, const Problem &problem)
+{
+    using State = typename Problem::state_type;
+    sweep_fixed<numint::stepper_euler<State, Time>>(points, options, problem, "euler");
+    sweep_fixed<numint::stepper_improved_euler<State, Time>>(points, options, problem, "improved_euler");
+    sweep_fixed<numint::stepper_midpoint<State, Time>>(points, options, problem, "midpoint");
+    sweep_fixed<numint::stepper_trapezoidal<State, Time>>(points, options, problem, "trapezoidal");
+    sweep_fixed<numint::stepper_simpsons<State, Time>>(points, options, problem, "simpsons");
+    sweep_fixed<numint::stepper_rk4<State, Time>>(points, options, problem, "rk4");
+    sweep_adaptive<adaptive<numint::stepper_euler<State, Time>>>(points, options, problem, "euler");
+    sweep_adaptive<adaptive<numint::stepper_improved_euler<State, Time>>>(points, options, problem, "improved_euler");
+    sweep_adaptive<adaptive<numint::stepper_midpoint<State, Time>>>(points, options, problem, "midpoint");
+    sweep_adaptive<adaptive<numint::stepper_trapezoidal<State, Time>>>(points, options, problem, "trapezoidal");
+    sweep_adaptive<adaptive<numint::stepper_simpsons<State, Time>>>(points, options, problem, "simpsons");
+    sweep_adaptive<adaptive<numint::stepper_rk4<State, Time>>>(points, options, problem, "rk4");
+}
+
+/// @brief Writes a number, as JSON, where non-finite numbers are null.
+/// @param out The output stream.
+/// @param value The number.
+void write_number(std::ostream &out, double value)
+{
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+/// @brief Writes the points as CSV, with a header.
+/// @param out The output stream.
+/// @param points The points.
+void write_csv(std::ostream &out, const std::vector<Point> &points)
+{
+    out << "problem,mode,stepper,setting,completed,steps,evaluations,error,samples,mean_s,ci95_s,min_s\n";
+    out << std::setprecision(9);
+    for (const Point &point : points) {
+        out << point.problem << "," << point.mode << "," << point.stepper << "," << point.setting << ","
+            << (point.completed ? 1 : 0) << "," << point.steps << "," << point.evaluations << "," << point.error
+            << "," << point.samples << "," << point.mean_s << "," << point.ci95_s << "," << point.min_s << "\n";
+    }
+}
+
+/// @brief Writes the points as JSON, one point per line.
+/// @param out The output stream.
+/// @param points The points.
+void write_json(std::ostream &out, const std::vector<Point> &points)
+{
+    out << "{\n\"points\": [" << std::setprecision(9);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Point &point = points[i];
+        out << (i == 0 ? "\n" : ",\n") << "{\"problem\": \"" << point.problem << "\", \"mode\": \"" << point.mode
+            << "\", \"stepper\": \"" << point.stepper << "\", \"setting\": " << point.setting
+            << ", \"completed\": " << (point.completed ? "true" : "false") << ", \"steps\": " << point.steps
+            << ", \"evaluations\": " << point.evaluations << ", \"error\": ";
+        write_number(out, point.error);
+        out << ", \"samples\": " << point.samples << ", \"mean_s\": " << point.mean_s
+            << ", \"ci95_s\": " << point.ci95_s << ", \"min_s\": " << point.min_s << "}";
+    }
+    out << "\n]\n}\n";
+}
+
+/// @brief Writes the points into a file.
+/// @param path The path of the file.
+/// @param points The points.
+/// @param writer The function writing them.
+template <class Writer>
+void write_file(const std::string &path, const std::vector<Point> &points, Writer writer)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot create `" + path + "`.");
+    }
+    writer(out, points);
+}
+
+/// @brief Parses the command line.
+/// @param argc The number of arguments.
+/// @param argv The arguments.
+/// @param options The settings of the sweep.
+/// @return true if the arguments are valid.
+auto parse_command_line(int argc, char **argv, Options &options) -> bool
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const bool has_value = (i + 1) < args.size();
+        if ((args[i] == "--filter") && has_value) {
+            options.filter = args[++i];
+        } else if ((args[i] == "--repeats") && has_value) {
+            options.repeats = std::stoul(args[++i]);
+        } else if ((args[i] == "--min-steps") && has_value) {
+            options.min_steps = std::max<std::uint64_t>(std::stoull(args[++i]), 1);
+        } else if ((args[i] == "--max-steps") && has_value) {
+            options.max_steps = std::stoull(args[++i]);
+        } else if ((args[i] == "--max-tolerance") && has_value) {
+            options.max_tolerance = std::stod(args[++i]);
+        } else if ((args[i] == "--min-tolerance") && has_value) {
+            options.min_tolerance = std::stod(args[++i]);
+        } else if ((args[i] == "--csv") && has_value) {
+            options.csv = args[++i];
+        } else if ((args[i] == "--json") && has_value) {
+            options.json = args[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter TEXT] [--repeats N] [--min-steps N] [--max-steps N]\n"
+                      << "       [--max-tolerance TOL] [--min-tolerance TOL] [--csv FILE] [--json FILE]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try {
+        Options options;
+        if (!parse_command_line(argc, argv, options)) {
+            return EXIT_FAILURE;
+        }
+        std::vector<Point> points;
+        sweep(points, options, numint::problems::lorenz());
+        sweep(points, options, numint::problems::arenstorf());
+        sweep(points, options, numint::problems::pleiades());
+        sweep(points, options, numint::problems::outer_solar_system());
+        sweep(points, options, numint::problems::robertson());
+        sweep(points, options, numint::problems::van_der_pol());
+        sweep(points, options, numint::problems::hires());
+        sweep(points, options, numint::problems::orego());
+        sweep(points, options, numint::problems::brusselator_2d());
+        if (!options.csv.empty()) {
+            write_file(options.csv, points, write_csv);
+        }
+        if (!options.json.empty()) {
+            write_file(options.json, points, write_json);
+        }
+        if (options.csv.empty() && options.json.empty()) {
+            write_csv(std::cout, points);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
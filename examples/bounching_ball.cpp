@@ -51,6 +51,8 @@ struct Parameter {
     Variable k = 5000;
     /// @brief Damping constant.
     Variable c = 5;
+    /// @brief Restitution coefficient, the one of the spring-damper contact.
+    Variable e = 0.78;
 };
 
 struct Model : public Parameter {
@@ -81,9 +83,29 @@ struct Model : public Parameter {
     }
 };
 
+/// @brief The ball in free fall, the contact is handled as an event.
+struct FreeFallModel : public Parameter {
+    explicit FreeFallModel(Parameter parameter)
+        : Parameter(parameter)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Free fall behaviour.
+    /// @param x the current state.
+    /// @param dxdt the final state.
+    /// @param t the current time.
+    inline void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = -g;
+        dxdt[1] = x[0];
+    }
+};
+
 template <std::size_t DECIMATION = 0>
 struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
+    inline void operator()(const State &x, const Time &t) noexcept
     {
         if (this->observe()) {
             time.emplace_back(t);
@@ -112,6 +134,7 @@ int main(int, char **)
     // Runtime state.
     State x_f;
     State x_a;
+    State x_e;
     // Initial states.
     const State x0{0.0, 1.0};
     // Simulation parameters.
@@ -122,6 +145,8 @@ int main(int, char **)
     const auto Iterations = 16;
     const auto Error      = numint::ErrorFormula::Mixed;
     using AdaptiveSolver  = numint::stepper_adaptive<FixedSolver, Iterations, Error>;
+    // Setup the model without the stiff contact.
+    FreeFallModel free_fall(parameter);
 
     // Instantiate the solvers.
     FixedSolver solver_f;
@@ -129,6 +154,20 @@ int main(int, char **)
     solver_a.set_tollerance(1e-09);
     solver_a.set_min_delta(1e-12);
     solver_a.set_max_delta(1e-02);
+    AdaptiveSolver solver_e;
+    solver_e.set_tollerance(1e-09);
+    solver_e.set_min_delta(1e-12);
+    solver_e.set_max_delta(1e-02);
+
+    // The contact, when the ball reaches the ground while falling, bounces it
+    // back up, and stops the simulation once the ball is at rest.
+    auto contact = numint::make_event(
+        [&free_fall](const State &x, Time) { return x[1] - free_fall.r; },
+        [&free_fall](State &x, Time) {
+            x[0] = -free_fall.e * x[0];
+            return (x[0] < 1e-03) ? numint::EventAction::Terminate : numint::EventAction::Continue;
+        },
+        numint::EventDirection::Falling);
 
     // Instantiate the observers.
 #ifdef ENABLE_PLOT
@@ -138,6 +177,7 @@ int main(int, char **)
 #endif
     Observer obs_f;
     Observer obs_a;
+    Observer obs_e;
 
     // Instantiate the stopwatch.
     timelib::Stopwatch sw;
@@ -146,6 +186,7 @@ int main(int, char **)
     // Set the initial state.
     x_f = x0;
     x_a = x0;
+    x_e = x0;
     // Start the simulation.
     sw.start();
     // Run the solver.
@@ -156,6 +197,10 @@ int main(int, char **)
     numint::integrate_adaptive(solver_a, obs_a, model, x_a, time_start, time_end, time_delta);
     // Get the elapsed time.
     sw.round();
+    // Run the solver, with the contact as an event.
+    numint::integrate_events(solver_e, obs_e, free_fall, x_e, time_start, time_end, time_delta, 1e-12, contact);
+    // Get the elapsed time.
+    sw.round();
 
     std::cout << "\n";
     std::cout << "Integration steps and elapsed times:\n";
@@ -163,6 +208,8 @@ int main(int, char **)
               << sw[0] << "\n";
     std::cout << "    Adaptive solver computed " << std::setw(12) << solver_a.steps() << " steps, for a total of "
               << sw[1] << "\n";
+    std::cout << "    Event solver computed    " << std::setw(12) << solver_e.steps() << " steps, for a total of "
+              << sw[2] << "\n";
 
 #ifdef ENABLE_PLOT
     // Plot the "Ground" line (horizontal at y=0)
@@ -190,6 +237,11 @@ int main(int, char **)
         .set_plot_type(gpcpp::plot_type_t::lines)
         .set_line_type(gpcpp::line_type_t::solid)
         .plot_xy(obs_a.time, obs_a.displacement, "Position A (m)")
+        // Plot 3
+        .set_line_width(2)
+        .set_plot_type(gpcpp::plot_type_t::lines)
+        .set_line_type(gpcpp::line_type_t::solid)
+        .plot_xy(obs_e.time, obs_e.displacement, "Position E (m)")
         // Plot the ground.
         .set_line_width(1)
         .set_plot_type(gpcpp::plot_type_t::lines)
@@ -6,6 +6,7 @@
 #include <exception>
 #include <iomanip>
 #include <iostream>
+#include <ratio>
 
 #include <timelib/stopwatch.hpp>
 
@@ -16,6 +17,7 @@
 #include "defines.hpp"
 
 #include <numint/detail/observer.hpp>
+#include <numint/detail/profiler.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
@@ -81,11 +83,13 @@ struct Model : public Parameter {
     }
 };
 
-template <std::size_t DECIMATION = 0>
-struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
+/// Samples the states in time, so that the steppers, whose steps differ, are
+/// plotted at the same rate.
+template <class Period = std::ratio<0>>
+struct ObserverSave : public numint::detail::ObserverSample<State, Time, Period> {
+    inline void operator()(const State &x, const Time &t) noexcept
     {
-        if (this->observe()) {
+        if (this->observe(t)) {
             time.emplace_back(t);
             angle.emplace_back(x[0]);
             velocity.emplace_back(x[1]);
@@ -125,6 +129,12 @@ inline void run_test_adaptive_step(
     std::cout << "    " << std::setw(16) << name;
     std::cout << " took " << std::setw(12) << stepper.steps() << " steps,";
     std::cout << " for a total of " << sw.last_round() << "\n";
+#ifdef NUMINT_STATISTICS
+    // Output the statistics.
+    const auto stats = stepper.stats();
+    std::cout << "    " << std::setw(16) << "" << " " << std::setw(12) << stats.rhs_evaluations << " evaluations,";
+    std::cout << " dt in [" << stats.min_delta << ", " << stats.max_delta << "], mean " << stats.mean_delta() << "\n";
+#endif
 }
 
 int main(int, char **)
@@ -151,7 +161,7 @@ int main(int, char **)
 
     // Setup the observers.
 #ifdef ENABLE_PLOT
-    using Observer = ObserverSave<0>;
+    using Observer = ObserverSave<std::centi>;
 #else
     using Observer = numint::detail::ObserverPrint<State, Time, 0>;
 #endif
@@ -173,9 +183,14 @@ int main(int, char **)
     run_test_adaptive_step("midpoint", midpoint, obs_midpoint, model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("trapezoidal", trapezoidal, obs_trapezoidal, model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("simpsons", simpsons, obs_simpsons, model, x0, start_time, end_time, delta_time);
-    run_test_adaptive_step("rk4", rk4, obs_rk4, model, x0, start_time, end_time, delta_time);
+    // Profile the evaluations of the model made by each stage of rk4.
+    numint::detail::profiled_system profiled_model(model);
+    run_test_adaptive_step("rk4", rk4, obs_rk4, profiled_model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("reference", reference, obs_reference, model, x0, start_time, end_time, 5e-04);
 
+    std::cout << "\nProfile of rk4:\n";
+    profiled_model.report(std::cout);
+
 #ifdef ENABLE_PLOT
     // Create a Gnuplot instance.
     gpcpp::Gnuplot gnuplot;
@@ -231,6 +246,10 @@ int main(int, char **)
         .plot_xy(obs_reference.time, obs_reference.angle, "reference.angle");
 
     gnuplot.show();
+#endif
+#ifdef NUMINT_TRACE
+    // Write the timeline of the integrations, to open with Perfetto or chrome://tracing.
+    numint::detail::write_chrome_trace("compare_adaptive.trace.json");
 #endif
     return 0;
 }
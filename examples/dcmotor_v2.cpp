@@ -18,6 +18,7 @@
 #include "defines.hpp"
 
 #include <numint/detail/observer.hpp>
+#include <numint/detail/recorder.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
@@ -126,21 +127,6 @@ struct Model : public Parameters {
     }
 };
 
-/// @brief The dc motor itself.
-template <std::size_t DECIMATION = 0>
-struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
-    {
-        if (this->observe()) {
-            time.emplace_back(t);
-            current.emplace_back(x[0]);
-            speed.emplace_back(x[1]);
-            temperature.emplace_back(x[2]);
-        }
-    }
-    std::vector<Variable> time, current, speed, temperature;
-};
-
 } // namespace dcmotor_v2
 
 int main(int, char **)
@@ -158,6 +144,8 @@ int main(int, char **)
     const Time time_end   = 1.0;
     const Time time_delta = 0.0001;
     const auto samples    = compute_samples<std::size_t>(time_start, time_end, time_delta);
+    // The input voltage and the load torque are switched on at these times.
+    const std::array<Time, 2> tstops{0.05, 0.2};
 
     // Setup the solvers.
     const auto Error      = numint::ErrorFormula::Mixed;
@@ -181,14 +169,19 @@ int main(int, char **)
 
     // Setup the observers.
 #ifdef ENABLE_PLOT
-    using Observer = ObserverSave<0>;
+    // The fixed-step recorders know how many samples to expect.
+    using Observer = numint::detail::ObserverRecord<State, Time>;
+    Observer obs_adaptive_euler;
+    Observer obs_adaptive_rk4;
+    Observer obs_euler(samples + 2);
+    Observer obs_rk4(samples + 2);
 #else
     using Observer = numint::detail::ObserverPrint<State, Time, 0>;
-#endif
     Observer obs_adaptive_euler;
     Observer obs_adaptive_rk4;
     Observer obs_euler;
     Observer obs_rk4;
+#endif
 
     // Instantiate the stopwatch.
     timelib::Stopwatch sw;
@@ -199,13 +192,13 @@ int main(int, char **)
     std::cout << "Simulating with `Adaptive Euler`...\n";
     x = x0;
     sw.start();
-    numint::integrate_adaptive(adaptive_euler, obs_adaptive_euler, model, x, time_start, time_end, time_delta);
+    numint::integrate_adaptive(adaptive_euler, obs_adaptive_euler, model, x, time_start, time_end, time_delta, tstops);
     sw.round();
 
     std::cout << "Simulating with `Adaptive RK4`...\n";
     x = x0;
     sw.start();
-    numint::integrate_adaptive(adaptive_rk4, obs_adaptive_rk4, model, x, time_start, time_end, time_delta);
+    numint::integrate_adaptive(adaptive_rk4, obs_adaptive_rk4, model, x, time_start, time_end, time_delta, tstops);
     sw.round();
 
     std::cout << "Simulating with `Euler`...\n";
@@ -248,78 +241,78 @@ int main(int, char **)
         .set_plot_type(gpcpp::plot_type_t::points)          // Points style
         .set_point_type(gpcpp::point_type_t::filled_circle) // Marker style: filled circle ("o")
         .set_point_size(1)                                  // Marker size
-        .plot_xy(obs_adaptive_euler.time, obs_adaptive_euler.current, "AdaptiveEuler.Current");
+        .plot_xy(obs_adaptive_euler.time(), obs_adaptive_euler.column(0), "AdaptiveEuler.Current");
 
     // Plot scatter for Adaptive Euler - Speed
     gnuplot
         .set_plot_type(gpcpp::plot_type_t::points)           // Points style
         .set_point_type(gpcpp::point_type_t::filled_diamond) // Marker style: filled circle ("o")
         .set_point_size(1)                                   // Marker size
-        .plot_xy(obs_adaptive_euler.time, obs_adaptive_euler.speed, "AdaptiveEuler.Speed");
+        .plot_xy(obs_adaptive_euler.time(), obs_adaptive_euler.column(1), "AdaptiveEuler.Speed");
 
     // Plot scatter for Adaptive Euler - Temperature
     gnuplot
         .set_plot_type(gpcpp::plot_type_t::points)          // Points style
         .set_point_type(gpcpp::point_type_t::filled_square) // Marker style: filled circle ("o")
         .set_point_size(1)                                  // Marker size
-        .plot_xy(obs_adaptive_euler.time, obs_adaptive_euler.temperature, "AdaptiveEuler.Temperature");
+        .plot_xy(obs_adaptive_euler.time(), obs_adaptive_euler.column(2), "AdaptiveEuler.Temperature");
 
     // Plot scatter for Adaptive RK4 - Current
     gnuplot
         .set_plot_type(gpcpp::plot_type_t::points)        // Points style
         .set_point_type(gpcpp::point_type_t::open_circle) // Marker style: filled diamond ("d")
         .set_point_size(2)                                // Marker size
-        .plot_xy(obs_adaptive_rk4.time, obs_adaptive_rk4.current, "AdaptiveRk4.Current");
+        .plot_xy(obs_adaptive_rk4.time(), obs_adaptive_rk4.column(0), "AdaptiveRk4.Current");
 
     // Plot scatter for Adaptive RK4 - Speed
     gnuplot
         .set_plot_type(gpcpp::plot_type_t::points)         // Points style
         .set_point_type(gpcpp::point_type_t::open_diamond) // Marker style: filled diamond ("d")
         .set_point_size(2)                                 // Marker size
-        .plot_xy(obs_adaptive_rk4.time, obs_adaptive_rk4.speed, "AdaptiveRk4.Speed");
+        .plot_xy(obs_adaptive_rk4.time(), obs_adaptive_rk4.column(1), "AdaptiveRk4.Speed");
 
     // Plot scatter for Adaptive RK4 - Temperature
     gnuplot
         .set_plot_type(gpcpp::plot_type_t::points)        // Points style
         .set_point_type(gpcpp::point_type_t::open_square) // Marker style: filled diamond ("d")
         .set_point_size(2)                                // Marker size
-        .plot_xy(obs_adaptive_rk4.time, obs_adaptive_rk4.temperature, "AdaptiveRk4.Temperature");
+        .plot_xy(obs_adaptive_rk4.time(), obs_adaptive_rk4.column(2), "AdaptiveRk4.Temperature");
 
     // Plot Euler method - Current
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_euler.time, obs_euler.current, "Euler.Current");
+        .plot_xy(obs_euler.time(), obs_euler.column(0), "Euler.Current");
 
     // Plot Euler method - Speed
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_euler.time, obs_euler.speed, "Euler.Speed");
+        .plot_xy(obs_euler.time(), obs_euler.column(1), "Euler.Speed");
 
     // Plot Euler method - Temperature
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_euler.time, obs_euler.temperature, "Euler.Temperature");
+        .plot_xy(obs_euler.time(), obs_euler.column(2), "Euler.Temperature");
 
     // Plot RK4 method - Current
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_rk4.time, obs_rk4.current, "Rk4.Current");
+        .plot_xy(obs_rk4.time(), obs_rk4.column(0), "Rk4.Current");
 
     // Plot RK4 method - Speed
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_rk4.time, obs_rk4.speed, "Rk4.Speed");
+        .plot_xy(obs_rk4.time(), obs_rk4.column(1), "Rk4.Speed");
 
     // Plot RK4 method - Temperature
     gnuplot
         .set_line_width(2)                        // Line width
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style
-        .plot_xy(obs_rk4.time, obs_rk4.temperature, "Rk4.Temperature");
+        .plot_xy(obs_rk4.time(), obs_rk4.column(2), "Rk4.Temperature");
 
     // Enable legend and display
     gnuplot.show();
@@ -0,0 +1,159 @@
+/// @file ensemble.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integrates an ensemble of Lotka-Volterra models, first one trajectory
+/// at a time, and then several trajectories per call by using batched states.
+
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <timelib/stopwatch.hpp>
+
+#include "defines.hpp"
+
+#include <numint/detail/batch.hpp>
+#include <numint/detail/observer.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+namespace ensemble
+{
+
+/// @brief The number of trajectories integrated together.
+constexpr std::size_t Lanes = 4;
+
+/// @brief A pack of variables, one per trajectory.
+using Batch = numint::detail::batch<Variable, Lanes>;
+
+/// @brief State of a single trajectory.
+/// x[0] : Prey
+/// x[1] : Predator
+using State = std::array<Variable, 2>;
+
+/// @brief State of `Lanes` trajectories, in structure-of-arrays form.
+using BatchState = std::array<Batch, 2>;
+
+/// @brief The Lotka-Volterra model, written once for any scalar type.
+/// @tparam Scalar either `Variable` or `Batch`.
+template <class Scalar>
+struct Model {
+    /// Growth rate of the prey.
+    Scalar alpha{1.5};
+    /// Predation rate.
+    Scalar beta{1.0};
+    /// Death rate of the predator.
+    Scalar gamma{3.0};
+    /// Growth rate of the predator.
+    Scalar delta{1.0};
+
+    /// @brief Lotka-Volterra behaviour.
+    /// @param x the current state.
+    /// @param dxdt the final state.
+    /// @param t the current time.
+    inline void operator()(const std::array<Scalar, 2> &x, std::array<Scalar, 2> &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = alpha * x[0] - beta * x[0] * x[1];
+        dxdt[1] = delta * x[0] * x[1] - gamma * x[1];
+    }
+};
+
+/// @brief Returns the growth rate of the prey for the given trajectory.
+/// @param index the index of the trajectory.
+/// @param count the number of trajectories.
+/// @return the growth rate.
+inline Variable sweep_alpha(std::size_t index, std::size_t count)
+{
+    return 1.0 + static_cast<Variable>(index) / static_cast<Variable>(count);
+}
+
+} // namespace ensemble
+
+int main(int, char **)
+{
+    using namespace ensemble;
+
+    // The number of trajectories.
+    const std::size_t trajectories = 1024;
+
+    // Simulation parameters.
+    const Time time_start = 0.0;
+    const Time time_end   = 10.0;
+    const Time time_delta = 0.001;
+
+    // Observer that discards everything, we only want the final states.
+    numint::detail::ObserverNull skip;
+
+    // Final states, with both approaches.
+    std::vector<State> scalar_final(trajectories);
+    std::vector<State> batch_final(trajectories);
+
+    // Instantiate the stopwatch.
+    timelib::Stopwatch sw;
+
+    std::cout << std::fixed;
+    std::cout << "Simulating " << trajectories << " trajectories with `RK4`, one at a time...\n";
+    sw.start();
+    for (std::size_t i = 0; i < trajectories; ++i) {
+        Model<Variable> model;
+        model.alpha = sweep_alpha(i, trajectories);
+        numint::stepper_rk4<State, Time> stepper;
+        State x{10., 4.};
+        numint::integrate_fixed(stepper, skip, model, x, time_start, time_end, time_delta);
+        scalar_final[i] = x;
+    }
+    sw.round();
+
+    std::cout << "Simulating " << trajectories << " trajectories with `RK4`, " << Lanes << " per call...\n";
+    sw.start();
+    for (std::size_t i = 0; i < trajectories; i += Lanes) {
+        Model<Batch> model;
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            model.alpha[lane] = sweep_alpha(i + lane, trajectories);
+        }
+        numint::stepper_rk4<BatchState, Time> stepper;
+        BatchState x{Batch(10.), Batch(4.)};
+        numint::integrate_fixed(stepper, skip, model, x, time_start, time_end, time_delta);
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            batch_final[i + lane] = State{x[0][lane], x[1][lane]};
+        }
+    }
+    sw.round();
+
+    // Check that the two approaches agree.
+    Variable max_difference = 0;
+    for (std::size_t i = 0; i < trajectories; ++i) {
+        for (std::size_t j = 0; j < 2; ++j) {
+            max_difference = std::max(max_difference, std::abs(scalar_final[i][j] - batch_final[i][j]));
+        }
+    }
+
+    // With the adaptive stepper, all the lanes share the same step-size, which
+    // is driven by the lane with the largest truncation error.
+    std::cout << "Simulating " << Lanes << " trajectories with `Adaptive RK4`, sharing the step-size...\n";
+    numint::stepper_adaptive<numint::stepper_rk4<BatchState, Time>, 2, numint::ErrorFormula::Mixed> adaptive;
+    adaptive.set_tollerance(1e-06);
+    adaptive.set_min_delta(1e-09);
+    adaptive.set_max_delta(1e-02);
+    Model<Batch> model;
+    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+        model.alpha[lane] = sweep_alpha(lane, Lanes);
+    }
+    BatchState x{Batch(10.), Batch(4.)};
+    sw.start();
+    numint::integrate_adaptive(adaptive, skip, model, x, time_start, time_end, time_delta);
+    sw.round();
+
+    std::cout << "\n";
+    std::cout << "Elapsed times:\n";
+    std::cout << "    One trajectory per call     : " << sw.partials()[0] << "\n";
+    std::cout << "    " << std::setw(2) << Lanes << " trajectories per call : " << sw.partials()[1] << "\n";
+    std::cout << "    Adaptive batch took " << std::setw(12) << adaptive.steps() << " steps, for a total of "
+              << sw.partials()[2] << "\n";
+    std::cout << "Largest difference between the two approaches: " << max_difference << "\n";
+    std::cout << "Final state of the adaptive batch: " << x << "\n";
+    return 0;
+}
@@ -0,0 +1,113 @@
+/// @file heat_equation.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integrates the heat equation on a rod discretized in millions of
+/// cells. Build with `NUMINT_PARALLEL_ALGEBRA` (the `ENABLE_PARALLEL_ALGEBRA`
+/// CMake option) to split the stepper algebra between threads.
+
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <timelib/stopwatch.hpp>
+
+#include "defines.hpp"
+
+#include <numint/detail/observer.hpp>
+#include <numint/detail/parallel.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+namespace heat_equation
+{
+
+/// @brief State of the system, the temperature of each cell. The allocator
+/// places each chunk of the state close to the thread which processes it.
+using State = std::vector<Variable, numint::detail::first_touch_allocator<Variable>>;
+
+/// @brief The rod, with both ends kept at zero degrees.
+struct Model {
+    /// Thermal diffusivity [m^2/s].
+    Variable alpha;
+    /// Length of each cell [m].
+    Variable dx;
+
+    /// @brief Heat equation behaviour, the cells are split between the threads
+    /// of the pool exactly like the stepper algebra does.
+    /// @param x the current state.
+    /// @param dxdt the final state.
+    /// @param t the current time.
+    inline void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        const std::size_t n = x.size();
+        const Variable k    = alpha / (dx * dx);
+        numint::detail::parallel_chunks<Variable>(n, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const Variable left  = (i > 0) ? x[i - 1] : 0.;
+                const Variable right = (i + 1 < n) ? x[i + 1] : 0.;
+                dxdt[i]              = k * (left - 2. * x[i] + right);
+            }
+        });
+    }
+};
+
+} // namespace heat_equation
+
+int main(int argc, char *argv[])
+{
+    using namespace heat_equation;
+
+    // The number of cells, it can be changed from the command line.
+    const std::size_t cells = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (std::size_t(1) << 22U);
+
+    // Instantiate the model.
+    Model model{1e-04, 1. / static_cast<Variable>(cells)};
+
+    // Simulation parameters, the time step is within the stability limit.
+    const Time time_start = 0.0;
+    const Time time_delta = 0.5 * model.dx * model.dx / model.alpha;
+    const Time time_end   = 100 * time_delta;
+
+    // Initial state, a hot spot in the middle of the rod.
+    State x(cells);
+    numint::detail::parallel_chunks<Variable>(cells, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            x[i] = ((4 * i > cells) && (4 * i < 3 * cells)) ? 100. : 0.;
+        }
+    });
+
+    // Setup the solver.
+    numint::stepper_rk4<State, Time> stepper;
+
+    // Observer that discards everything, we only want the final state.
+    numint::detail::ObserverNull skip;
+
+    // Instantiate the stopwatch.
+    timelib::Stopwatch sw;
+
+    std::cout << std::fixed;
+    std::cout << "Simulating " << cells << " cells with `RK4`, using "
+              << numint::detail::thread_pool::instance().size() << " threads for the model";
+#ifdef NUMINT_PARALLEL_ALGEBRA
+    std::cout << " and for the algebra...\n";
+#else
+    std::cout << ", and one for the algebra...\n";
+#endif
+    sw.start();
+    numint::integrate_fixed(stepper, skip, model, x, time_start, time_end, time_delta);
+    sw.round();
+
+    // Compute the total heat left in the rod.
+    Variable heat = 0;
+    for (const auto &value : x) {
+        heat += value * model.dx;
+    }
+
+    std::cout << "\n";
+    std::cout << "RK4 took " << std::setw(12) << stepper.steps() << " steps, for a total of " << sw.last_round()
+              << "\n";
+    std::cout << "Heat left in the rod: " << heat << "\n";
+    return 0;
+}
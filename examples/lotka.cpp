@@ -48,7 +48,7 @@ public:
 
 template <std::size_t DECIMATION = 0>
 struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
+    inline void operator()(const State &x, const Time &t) noexcept
     {
         if (this->observe()) {
             time.emplace_back(t);
@@ -15,8 +15,10 @@
 
 #include "defines.hpp"
 
+#include <numint/detail/async_observer.hpp>
 #include <numint/detail/observer.hpp>
 #include <numint/solver.hpp>
+#include <numint/steps.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
 #include <numint/stepper/stepper_improved_euler.hpp>
@@ -116,7 +118,7 @@ struct Model : public Parameters {
 /// @brief The dc motor itself.
 template <std::size_t DECIMATION = 0>
 struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
+    inline void operator()(const State &x, const Time &t) noexcept
     {
         if (this->observe()) {
             time.emplace_back(t);
@@ -157,17 +159,29 @@ int main(int, char **)
 #ifdef ENABLE_PLOT
     using Observer = ObserverSave<0>;
 #else
-    using Observer = numint::detail::ObserverPrint<State, Time, 0>;
+    // Print from a background thread, to keep the output off the integration.
+    using Observer = numint::detail::ObserverAsync<State, Time>;
 #endif
     Observer observer;
     // Instantiate the stopwatch.
     timelib::Stopwatch sw;
     x = x0;
     sw.start();
-    numint::integrate_adaptive(stepper, observer, model, x, time_start, time_end / 2, time_delta);
+    // Pull the steps one at a time, switching mode halfway through.
+    auto steps = numint::steps(stepper, model, x, time_start, time_end, time_delta);
+    observer(x, time_start);
+    while (steps.next(time_end / 2)) {
+        observer(x, steps.time());
+    }
     model.Gr = 10;
-    numint::integrate_adaptive(stepper, observer, model, x, time_end / 2, time_end, time_delta);
+    for (const auto &step : steps) {
+        observer(step.state, step.time);
+    }
     sw.round();
+#ifndef ENABLE_PLOT
+    // Wait for the writer thread to print everything.
+    observer.stop();
+#endif
     std::cout << "Integration took " << std::setw(12) << stepper.steps() << " steps, for a total of " << sw.last_round()
               << "\n";
 
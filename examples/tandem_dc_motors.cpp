@@ -16,6 +16,7 @@
 #include "defines.hpp"
 
 #include <numint/detail/observer.hpp>
+#include <numint/resimulation.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
@@ -340,7 +341,7 @@ struct Model : public Parameters {
 /// @brief The dc motor itself.
 template <std::size_t DECIMATION = 0>
 struct ObserverSave : public numint::detail::ObserverDecimate<State, Time, DECIMATION> {
-    inline void operator()(const State &x, const Time &t) noexcept override
+    inline void operator()(const State &x, const Time &t) noexcept
     {
         if (this->observe()) {
             time.emplace_back(t);
@@ -408,27 +409,63 @@ int main(int, char **)
     Sequence sequence = {
         Step{mode_0, 150.}, Step{mode_1, 150.}, Step{mode_2, 150.}, Step{mode_3, 150.}, Step{mode_4, 150.}};
 
+    // Turn the sequence into the times at which the mode changes.
+    std::vector<numint::Breakpoint<Time, Mode>> schedule;
+    for (const auto &step : sequence) {
+        schedule.push_back({time, step.mode});
+        time += step.duration;
+    }
+
+    // Switch the mode of the model at each breakpoint.
+    const auto update = [&model](const numint::Breakpoint<Time, Mode> &breakpoint, State &) {
+        model.mode = breakpoint.value;
+    };
+    // Keep a snapshot every 10 seconds, to re-simulate what-if variants of the sequence.
+    numint::resimulation_cache<AdaptiveRk4> cache(10.);
+
     // Set the initial state.
     x = x0;
     // Start the simulation.
     sw.start();
-    for (std::size_t i = 0; i < sequence.size(); ++i) {
-        // Set the mode.
-        model.mode    = sequence[i].mode;
-        // Get the duration.
-        Time duration = sequence[i].duration;
-        // Run the solver.
-        numint::integrate_adaptive(solver, obs, model, x, time, time + duration, time_delta);
-        // Advance time.
-        time += duration;
-    }
+    // Run the solver, switching mode at each breakpoint.
+    numint::integrate_schedule_cached(cache, solver, obs, model, x, time_start, time, time_delta, 0, schedule, update);
     // Get the elapsed time.
     sw.round();
 
+    // What if the fourth step of the sequence used the lowest mode? Only what
+    // comes after its beginning is simulated again.
+    AdaptiveRk4 whatif;
+    whatif.set_tollerance(1e-06);
+    whatif.set_min_delta(1e-09);
+    whatif.set_max_delta(1e-01);
+    numint::detail::ObserverNull skip;
+    schedule[3].value = mode_0;
+    x                 = x0;
+    const std::size_t cached = cache.snapshots().size();
+    sw.start();
+    const Time restart = numint::integrate_schedule_cached(
+        cache, whatif, skip, model, x, time_start, time, time_delta, 0, schedule, update);
+    sw.round();
+    // The stepper resumed the count of steps of the snapshot it restarted
+    // from, the latest one of the first run not after the restart.
+    std::uint64_t resumed = 0;
+    for (std::size_t i = 0; i < cached; ++i) {
+        const auto &snapshot = cache.snapshots()[i];
+        if (!(restart < snapshot.time)) {
+            AdaptiveRk4 stepper;
+            numint::detail::checkpoint_reader reader;
+            reader.assign(snapshot.stepper);
+            stepper.load(reader);
+            resumed = stepper.steps();
+        }
+    }
+
     std::cout << "\n";
     std::cout << "Integration steps and elapsed times:\n";
     std::cout << "    Adaptive solver took " << std::setw(12) << solver.steps() << " steps, for a total of "
               << sw.partials()[0] << "\n";
+    std::cout << "    What-if run restarted at " << restart << " s, and took " << std::setw(12) << (whatif.steps() - resumed)
+              << " steps, for a total of " << sw.partials()[1] << "\n";
 
 #ifdef ENABLE_PLOT
     // Create a Gnuplot instance.
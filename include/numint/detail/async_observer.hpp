@@ -0,0 +1,287 @@
+/// @file async_observer.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An observer which moves the output off the integration thread: the
+/// states are copied into a lock-free ring, and written by a background thread.
+
+#pragma once
+
+#include "numint/detail/observer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace numint::detail
+{
+
+/// What the integration thread does when the ring of an asynchronous observer
+/// is full.
+enum class OverflowPolicy : unsigned char {
+    Block,   ///< Wait (spinning) for the writer to make room, nothing is lost.
+    Drop,    ///< Discard the states which do not fit.
+    Decimate ///< Keep one state every few, halving the rate each time the ring fills up.
+};
+
+/// @brief A lock-free ring with a single producer and a single consumer. The
+/// slots are allocated once, and reused: the producer fills them in place, and
+/// the consumer reads them in place.
+/// @tparam T the type of the elements.
+template <class T>
+class spsc_ring
+{
+public:
+    /// @brief Creates a new ring.
+    /// @param capacity The minimum number of elements, rounded up to a power of two.
+    /// @param value The value the slots are initialized with.
+    explicit spsc_ring(std::size_t capacity, const T &value = T())
+        : m_slots(round_up(capacity), value)
+        , m_mask(m_slots.size() - 1)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of slots.
+    /// @return The number of slots.
+    auto capacity() const noexcept -> std::size_t { return m_slots.size(); }
+
+    /// @brief Returns the number of elements waiting to be consumed.
+    /// @return The number of elements.
+    auto size() const noexcept -> std::size_t
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    /// @brief Fills the next slot, to be called only by the producer.
+    /// @param fill Function called as `fill(slot)`.
+    /// @return false if the ring is full.
+    template <class Fill>
+    auto try_push(Fill &&fill) -> bool
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if ((head - m_tail_cache) == m_slots.size()) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if ((head - m_tail_cache) == m_slots.size()) {
+                return false;
+            }
+        }
+        fill(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Consumes the oldest element, to be called only by the consumer.
+    /// @param consume Function called as `consume(slot)`.
+    /// @return false if the ring is empty.
+    template <class Consume>
+    auto try_pop(Consume &&consume) -> bool
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head_cache) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail == m_head_cache) {
+                return false;
+            }
+        }
+        consume(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /// @brief Rounds the capacity up to a power of two.
+    /// @param capacity The capacity.
+    /// @return The rounded capacity.
+    static auto round_up(std::size_t capacity) noexcept -> std::size_t
+    {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1U;
+        }
+        return size;
+    }
+
+    /// The slots.
+    std::vector<T> m_slots;
+    /// The mask turning a position into the index of a slot.
+    std::size_t m_mask;
+    /// The position of the next slot to fill, written by the producer.
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    /// The last position of the consumer seen by the producer.
+    std::size_t m_tail_cache{0};
+    /// The position of the next slot to consume, written by the consumer.
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    /// The last position of the producer seen by the consumer.
+    std::size_t m_head_cache{0};
+};
+
+/// @brief Observer that writes the states from a background thread.
+///
+/// @details The integration thread only copies the state and the time into a
+/// preallocated ring, without locks nor system calls, and a writer thread
+/// passes them to the writer function (e.g., formatting them to a stream).
+/// When the ring is full, the `OverflowPolicy` decides whether the integration
+/// waits, or states are discarded. The writer thread polls the ring, sleeping
+/// when it is empty, so that the integration thread never has to wake it up.
+/// States which allocate (e.g., `std::vector`) only do so the first time each
+/// slot is filled.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class ObserverAsync : public Observer<State, Time>
+{
+public:
+    /// @brief The type of the function writing the states.
+    using writer_type = std::function<void(const State &, const Time &)>;
+
+    /// @brief Creates the observer, and starts the writer thread.
+    /// @param writer The function writing the states, defaults to printing them like `ObserverPrint`.
+    /// @param capacity The number of states the ring holds.
+    /// @param policy What to do when the ring is full.
+    /// @param poll How long the writer thread sleeps when the ring is empty.
+    explicit ObserverAsync(
+        writer_type writer =
+            [](const State &x, const Time &t) {
+                std::cout << t << " " << x << "\n";
+            },
+        std::size_t capacity          = 4096,
+        OverflowPolicy policy         = OverflowPolicy::Block,
+        std::chrono::microseconds poll = std::chrono::microseconds(100))
+        : m_writer(std::move(writer))
+        , m_ring(capacity)
+        , m_policy(policy)
+        , m_poll(poll)
+        , m_stride(1)
+        , m_count(0)
+        , m_dropped(0)
+        , m_stop(false)
+        , m_thread(&ObserverAsync::run, this)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Writes the states left in the ring, and stops the writer thread.
+    ~ObserverAsync() { this->stop(); }
+
+    /// @brief Copy constructor, deleted as the writer thread points to the observer.
+    ObserverAsync(const ObserverAsync &other) = delete;
+
+    /// @brief Move constructor, deleted as the writer thread points to the observer.
+    ObserverAsync(ObserverAsync &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the writer thread points to the observer.
+    /// @return Reference to the observer.
+    auto operator=(const ObserverAsync &other) -> ObserverAsync & = delete;
+
+    /// @brief Move assignment operator, deleted as the writer thread points to the observer.
+    /// @return Reference to the observer.
+    auto operator=(ObserverAsync &&other) -> ObserverAsync & = delete;
+
+    /// @brief Copies the state and the time into the ring.
+    /// @param x The state vector.
+    /// @param t The time.
+    void operator()(const State &x, const Time &t)
+    {
+        if (m_policy == OverflowPolicy::Decimate) {
+            if (++m_count < m_stride) {
+                return;
+            }
+            m_count = 0;
+        }
+        const auto fill = [&](entry &slot) {
+            slot.state = x;
+            slot.time  = t;
+        };
+        if (m_ring.try_push(fill)) {
+            // Get back to the full rate once the writer caught up.
+            if ((m_stride > 1) && (m_ring.size() < (m_ring.capacity() / 4))) {
+                m_stride /= 2;
+            }
+            return;
+        }
+        if (m_policy == OverflowPolicy::Block) {
+            while (!m_ring.try_push(fill)) {
+                // Wait for the writer.
+            }
+            return;
+        }
+        if (m_policy == OverflowPolicy::Decimate) {
+            m_stride *= 2;
+        }
+        ++m_dropped;
+    }
+
+    /// @brief Waits until the writer thread wrote all the states in the ring.
+    void wait() const
+    {
+        while (m_ring.size() > 0) {
+            std::this_thread::sleep_for(m_poll);
+        }
+    }
+
+    /// @brief Writes the states left in the ring, and stops the writer thread.
+    /// The observer must not be called afterwards.
+    void stop()
+    {
+        if (m_thread.joinable()) {
+            m_stop.store(true, std::memory_order_release);
+            m_thread.join();
+        }
+    }
+
+    /// @brief Returns the number of states discarded because the ring was full.
+    /// @return The number of states discarded.
+    auto dropped() const noexcept -> std::size_t { return m_dropped; }
+
+private:
+    /// @brief An element of the ring.
+    struct entry {
+        /// The state vector.
+        State state;
+        /// The time.
+        Time time;
+    };
+
+    /// @brief The loop of the writer thread.
+    void run()
+    {
+        const auto write = [this](const entry &slot) { m_writer(slot.state, slot.time); };
+        while (true) {
+            // Read the flag first, so that the states pushed before it are written.
+            const bool stopping = m_stop.load(std::memory_order_acquire);
+            while (m_ring.try_pop(write)) {
+                // Keep writing.
+            }
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(m_poll);
+        }
+    }
+
+    /// The function writing the states.
+    writer_type m_writer;
+    /// The ring shared with the writer thread.
+    spsc_ring<entry> m_ring;
+    /// What to do when the ring is full.
+    OverflowPolicy m_policy;
+    /// How long the writer thread sleeps when the ring is empty.
+    std::chrono::microseconds m_poll;
+    /// Only one state every `m_stride` is kept, when decimating.
+    std::size_t m_stride;
+    /// The number of states skipped since the last one kept, when decimating.
+    std::size_t m_count;
+    /// The number of states discarded.
+    std::size_t m_dropped;
+    /// Tells the writer thread to stop.
+    std::atomic<bool> m_stop;
+    /// The writer thread, started last.
+    std::thread m_thread;
+};
+
+} // namespace numint::detail
@@ -0,0 +1,286 @@
+/// @file batch.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A fixed-width pack of scalars, which allows to integrate several
+/// trajectories of the same model at once, one trajectory per lane.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+
+namespace numint::detail
+{
+
+/// @brief A pack of `Lanes` scalars laid out contiguously, so that the
+/// element-wise operations below map onto SIMD registers.
+///
+/// @details A state such as `std::array<batch<double, 4>, 2>` holds four
+/// trajectories of a two-state model in structure-of-arrays form. A model
+/// whose `operator()` is templated on the scalar type evaluates all the lanes
+/// with a single call. Models must be branch-free on the state, use `select`
+/// to express lane-wise conditions.
+///
+/// @tparam T The scalar type of each lane.
+/// @tparam Lanes The number of lanes.
+template <class T, std::size_t Lanes>
+class batch
+{
+public:
+    /// @brief Type of the scalar contained in each lane.
+    using value_type = T;
+
+    /// @brief The number of lanes.
+    static constexpr std::size_t lanes = Lanes;
+
+    /// @brief The alignment of the pack, a whole vector register when the
+    /// number of lanes is a power of two.
+    static constexpr std::size_t alignment = ((Lanes & (Lanes - 1)) == 0) ? sizeof(T) * Lanes : alignof(T);
+
+    /// @brief Constructs a pack with all the lanes set to zero.
+    constexpr batch() noexcept = default;
+
+    /// @brief Constructs a pack with all the lanes set to the same value.
+    /// @param value The value to broadcast.
+    constexpr batch(T value) noexcept // NOLINT(google-explicit-constructor)
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] = value;
+        }
+    }
+
+    /// @brief Constructs a pack from the values of each lane.
+    /// @param values The values of the lanes.
+    constexpr batch(const std::array<T, Lanes> &values) noexcept // NOLINT(google-explicit-constructor)
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] = values[i];
+        }
+    }
+
+    /// @brief Get the value of the given lane.
+    /// @param lane the index of the lane.
+    /// @return The value of the lane.
+    constexpr auto operator[](std::size_t lane) -> T & { return m_data[lane]; }
+
+    /// @brief Get the value of the given lane.
+    /// @param lane the index of the lane.
+    /// @return The value of the lane.
+    constexpr auto operator[](std::size_t lane) const -> const T & { return m_data[lane]; }
+
+    /// @brief Lane-wise accumulation.
+    /// @param rhs the other pack.
+    /// @return a reference to this pack.
+    constexpr auto operator+=(const batch &rhs) noexcept -> batch &
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] += rhs.m_data[i];
+        }
+        return *this;
+    }
+
+    /// @brief Lane-wise subtraction.
+    /// @param rhs the other pack.
+    /// @return a reference to this pack.
+    constexpr auto operator-=(const batch &rhs) noexcept -> batch &
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] -= rhs.m_data[i];
+        }
+        return *this;
+    }
+
+    /// @brief Lane-wise multiplication.
+    /// @param rhs the other pack.
+    /// @return a reference to this pack.
+    constexpr auto operator*=(const batch &rhs) noexcept -> batch &
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] *= rhs.m_data[i];
+        }
+        return *this;
+    }
+
+    /// @brief Lane-wise division.
+    /// @param rhs the other pack.
+    /// @return a reference to this pack.
+    constexpr auto operator/=(const batch &rhs) noexcept -> batch &
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            m_data[i] /= rhs.m_data[i];
+        }
+        return *this;
+    }
+
+    /// @brief Lane-wise negation.
+    /// @param rhs the pack.
+    /// @return the negated pack.
+    friend constexpr auto operator-(batch rhs) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            rhs.m_data[i] = -rhs.m_data[i];
+        }
+        return rhs;
+    }
+
+    /// @brief Lane-wise sum.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto operator+(batch lhs, const batch &rhs) noexcept -> batch { return lhs += rhs; }
+
+    /// @brief Lane-wise difference.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto operator-(batch lhs, const batch &rhs) noexcept -> batch { return lhs -= rhs; }
+
+    /// @brief Lane-wise product.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto operator*(batch lhs, const batch &rhs) noexcept -> batch { return lhs *= rhs; }
+
+    /// @brief Lane-wise quotient.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto operator/(batch lhs, const batch &rhs) noexcept -> batch { return lhs /= rhs; }
+
+    /// @brief Lane-wise absolute value.
+    /// @param value the pack.
+    /// @return the resulting pack.
+    friend auto abs(batch value) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            value.m_data[i] = std::abs(value.m_data[i]);
+        }
+        return value;
+    }
+
+    /// @brief Lane-wise square root.
+    /// @param value the pack.
+    /// @return the resulting pack.
+    friend auto sqrt(batch value) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            value.m_data[i] = std::sqrt(value.m_data[i]);
+        }
+        return value;
+    }
+
+    /// @brief Lane-wise sine.
+    /// @param value the pack.
+    /// @return the resulting pack.
+    friend auto sin(batch value) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            value.m_data[i] = std::sin(value.m_data[i]);
+        }
+        return value;
+    }
+
+    /// @brief Lane-wise cosine.
+    /// @param value the pack.
+    /// @return the resulting pack.
+    friend auto cos(batch value) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            value.m_data[i] = std::cos(value.m_data[i]);
+        }
+        return value;
+    }
+
+    /// @brief Lane-wise exponential.
+    /// @param value the pack.
+    /// @return the resulting pack.
+    friend auto exp(batch value) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            value.m_data[i] = std::exp(value.m_data[i]);
+        }
+        return value;
+    }
+
+    /// @brief Lane-wise minimum.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto min(batch lhs, const batch &rhs) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            lhs.m_data[i] = (rhs.m_data[i] < lhs.m_data[i]) ? rhs.m_data[i] : lhs.m_data[i];
+        }
+        return lhs;
+    }
+
+    /// @brief Lane-wise maximum.
+    /// @param lhs the first pack.
+    /// @param rhs the second pack.
+    /// @return the resulting pack.
+    friend constexpr auto max(batch lhs, const batch &rhs) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            lhs.m_data[i] = (lhs.m_data[i] < rhs.m_data[i]) ? rhs.m_data[i] : lhs.m_data[i];
+        }
+        return lhs;
+    }
+
+    /// @brief Lane-wise selection, the branch-free replacement of an `if` on
+    /// the state.
+    /// @param condition the lanes where `condition > 0` take the value from `if_true`.
+    /// @param if_true the values selected where the condition holds.
+    /// @param if_false the values selected elsewhere.
+    /// @return the resulting pack.
+    friend constexpr auto select(const batch &condition, const batch &if_true, batch if_false) noexcept -> batch
+    {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            if_false.m_data[i] = (condition.m_data[i] > T(0)) ? if_true.m_data[i] : if_false.m_data[i];
+        }
+        return if_false;
+    }
+
+    /// @brief Returns the largest value among the lanes, which is used to
+    /// share a single step-size between all the lanes.
+    /// @param value the pack.
+    /// @return the largest value.
+    friend constexpr auto reduce_max(const batch &value) noexcept -> T
+    {
+        T ret = value.m_data[0];
+        for (std::size_t i = 1; i < Lanes; ++i) {
+            ret = (ret < value.m_data[i]) ? value.m_data[i] : ret;
+        }
+        return ret;
+    }
+
+    /// @brief Prints the lanes of the pack.
+    /// @param lhs the output stream.
+    /// @param rhs the pack.
+    /// @return the output stream.
+    friend auto operator<<(std::ostream &lhs, const batch &rhs) -> std::ostream &
+    {
+        lhs << "{";
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            lhs << ((i > 0) ? " " : "") << rhs.m_data[i];
+        }
+        return lhs << "}";
+    }
+
+private:
+    /// The value of each lane.
+    alignas(alignment) std::array<T, Lanes> m_data{};
+};
+
+/// @brief The scalar type of a batch is the type of its lanes.
+/// @tparam T The scalar type of each lane.
+/// @tparam Lanes The number of lanes.
+template <class T, std::size_t Lanes>
+struct scalar_type<batch<T, Lanes>> {
+    /// @brief The type of the lanes.
+    using type = T;
+};
+
+} // namespace numint::detail
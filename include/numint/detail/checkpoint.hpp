@@ -0,0 +1,215 @@
+/// @file checkpoint.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Binary checkpoints of an integration: the state of the stepper, the
+/// time, the step size, and the state vector, from which the integration can
+/// continue exactly as if it had never been interrupted.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace numint::detail
+{
+
+/// @brief Layout of a checkpoint file: a header followed by the payload.
+///
+/// @details The header holds the magic, the version, the size of the payload,
+/// and its FNV-1a hash, so that a truncated or corrupted file is rejected. The
+/// values are stored as they are in memory, hence a checkpoint can only be
+/// read back by the same build, on the same kind of machine.
+namespace checkpoint_format
+{
+
+/// The magic at the beginning of the file.
+constexpr char magic[8] = {'N', 'U', 'M', 'I', 'N', 'T', 'C', 'P'};
+/// The version of the layout, 2 since `stepper_adaptive` holds one stepper.
+constexpr std::uint32_t version = 2;
+/// The size of the header: magic, version, padding, payload size, and hash.
+constexpr std::size_t header_size = 32;
+
+/// @brief Computes the FNV-1a hash of a sequence of bytes.
+/// @param data The bytes.
+/// @param size The number of bytes.
+/// @return The hash.
+inline auto hash(const char *data, std::size_t size) noexcept -> std::uint64_t
+{
+    std::uint64_t value = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+} // namespace checkpoint_format
+
+/// @brief Gathers the content of a checkpoint, and writes it to a file.
+class checkpoint_writer
+{
+public:
+    /// @brief Appends a value.
+    /// @param value The value, which must be trivially copyable.
+    template <class T>
+    void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be checkpointed.");
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    /// @brief Appends a state vector, preceded by its size.
+    /// @param x The state vector.
+    template <class State>
+    void write_state(const State &x)
+    {
+        this->write(static_cast<std::uint64_t>(x.size()));
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            this->write(x[i]);
+        }
+    }
+
+    /// @brief Returns the content gathered so far.
+    /// @return The bytes of the payload.
+    auto data() const -> const std::vector<char> & { return m_data; }
+
+    /// @brief Writes the checkpoint to a file. The file is first written
+    /// aside, and then renamed, so that an interruption while writing leaves
+    /// the previous checkpoint intact.
+    /// @param path The path of the file.
+    void save(const std::string &path) const
+    {
+        char header[checkpoint_format::header_size] = {};
+        const std::uint32_t version = checkpoint_format::version;
+        const std::uint64_t size    = m_data.size();
+        const std::uint64_t hash    = checkpoint_format::hash(m_data.data(), m_data.size());
+        std::memcpy(header, checkpoint_format::magic, 8);
+        std::memcpy(header + 8, &version, 4);
+        std::memcpy(header + 16, &size, 8);
+        std::memcpy(header + 24, &hash, 8);
+        const std::string temporary = path + ".tmp";
+        std::FILE *file             = std::fopen(temporary.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot create the checkpoint `" + temporary + "`.");
+        }
+        bool written = (std::fwrite(header, 1, sizeof(header), file) == sizeof(header)) &&
+                       (std::fwrite(m_data.data(), 1, m_data.size(), file) == m_data.size());
+#if defined(__unix__) || defined(__APPLE__)
+        // The content must reach the disk before the rename does, otherwise a
+        // crash could leave an empty checkpoint in place of the previous one.
+        written = written && (std::fflush(file) == 0) && (::fsync(::fileno(file)) == 0);
+#endif
+        if ((std::fclose(file) != 0) || !written) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Cannot write the checkpoint `" + temporary + "`.");
+        }
+#ifdef _WIN32
+        // Renaming does not replace an existing file on Windows.
+        std::remove(path.c_str());
+#endif
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace the checkpoint `" + path + "`.");
+        }
+    }
+
+private:
+    /// The payload.
+    std::vector<char> m_data;
+};
+
+/// @brief Reads back the content of a checkpoint, in the order it was written.
+class checkpoint_reader
+{
+public:
+    /// @brief Reads a checkpoint file.
+    /// @param path The path of the file.
+    /// @return false if the file does not exist, throws if it is not a valid checkpoint.
+    auto open(const std::string &path) -> bool
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        char header[checkpoint_format::header_size] = {};
+        std::uint32_t version                       = 0;
+        std::uint64_t size = 0, hash = 0;
+        bool valid = (std::fread(header, 1, sizeof(header), file) == sizeof(header)) &&
+                     (std::memcmp(header, checkpoint_format::magic, 8) == 0);
+        if (valid) {
+            std::memcpy(&version, header + 8, 4);
+            std::memcpy(&size, header + 16, 8);
+            std::memcpy(&hash, header + 24, 8);
+            valid = (version == checkpoint_format::version);
+        }
+        if (valid) {
+            m_data.resize(size);
+            valid = (std::fread(m_data.data(), 1, m_data.size(), file) == m_data.size()) &&
+                    (checkpoint_format::hash(m_data.data(), m_data.size()) == hash);
+        }
+        std::fclose(file);
+        if (!valid) {
+            throw std::runtime_error("The checkpoint `" + path + "` is not valid.");
+        }
+        m_position = 0;
+        return true;
+    }
+
+    /// @brief Reads a checkpoint kept in memory, i.e., what `checkpoint_writer::data()` returns.
+    /// @param data The payload.
+    void assign(std::vector<char> data)
+    {
+        m_data     = std::move(data);
+        m_position = 0;
+    }
+
+    /// @brief Reads a value.
+    /// @param value The value, which must be trivially copyable.
+    template <class T>
+    void read(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be checkpointed.");
+        if ((m_data.size() - m_position) < sizeof(T)) {
+            throw std::runtime_error("The checkpoint ends unexpectedly.");
+        }
+        std::memcpy(&value, m_data.data() + m_position, sizeof(T));
+        m_position += sizeof(T);
+    }
+
+    /// @brief Reads a state vector, resizing it if possible.
+    /// @param x The state vector.
+    template <class State>
+    void read_state(State &x)
+    {
+        std::uint64_t size = 0;
+        this->read(size);
+        if constexpr (has_resize_v<State>) {
+            x.resize(size);
+        }
+        if (size != x.size()) {
+            throw std::runtime_error("The checkpoint does not match the dimension of the state.");
+        }
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            this->read(x[i]);
+        }
+    }
+
+private:
+    /// The payload.
+    std::vector<char> m_data;
+    /// The position of the next value to read.
+    std::size_t m_position{};
+};
+
+} // namespace numint::detail
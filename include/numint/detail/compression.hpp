@@ -0,0 +1,643 @@
+/// @file compression.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Streaming compression of trajectories, based on the fact that
+/// adjacent samples differ very little: an observer encodes the samples into
+/// a stream of bytes, and a decoder reads them back as they arrive.
+///
+/// @details The times are encoded with a delta-of-delta of their bit patterns,
+/// which is zero for a fixed step. Each column is either lossless, encoded with
+/// the XOR of the bit patterns of consecutive values (as in Gorilla), or lossy,
+/// rounded to a multiple of twice its error bound, and encoded with a
+/// delta-of-delta of the multiples.
+///
+/// The stream starts with a header, followed by blocks. All the numbers are
+/// little-endian.
+///
+///     header: "NUMINTZ1", size of the time values (1 byte), size of the state
+///             values (1 byte), 2 bytes of padding, number of columns (4 bytes),
+///             and the error bound of each column (8 bytes each, a double,
+///             zero for lossless columns)
+///     block:  number of rows (4 bytes), number of bytes of the payload (4
+///             bytes), and the payload, a stream of bits
+///
+/// The encoders carry over from one block to the next, so a block can only be
+/// decoded after the previous ones.
+
+#pragma once
+
+#include "numint/detail/observer.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numint::detail
+{
+
+namespace compression
+{
+
+/// The magic number at the beginning of the stream.
+constexpr const char magic[8] = {'N', 'U', 'M', 'I', 'N', 'T', 'Z', '1'};
+
+/// @brief Returns the unsigned integer with the same size of the given type.
+template <class T>
+using bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+/// @brief Returns the bit pattern of a value.
+/// @param value The value.
+/// @return The bit pattern.
+template <class T>
+inline auto to_bits(const T &value) noexcept -> std::uint64_t
+{
+    static_assert((sizeof(T) == 4) || (sizeof(T) == 8), "Only 32 and 64 bits values can be compressed.");
+    bits_t<T> bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+}
+
+/// @brief Returns the value with the given bit pattern.
+/// @param bits The bit pattern.
+/// @return The value.
+template <class T>
+inline auto from_bits(std::uint64_t bits) noexcept -> T
+{
+    const auto narrow = static_cast<bits_t<T>>(bits);
+    T value;
+    std::memcpy(&value, &narrow, sizeof(T));
+    return value;
+}
+
+/// @brief Counts the leading zeros of a value of the given width.
+/// @param value The value, not zero.
+/// @param width The width of the value, in bits.
+/// @return The number of leading zeros.
+inline auto leading_zeros(std::uint64_t value, unsigned width) noexcept -> unsigned
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clzll(value)) - (64U - width);
+#else
+    unsigned count = 0;
+    for (std::uint64_t bit = std::uint64_t(1) << (width - 1); (value & bit) == 0; bit >>= 1U) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// @brief Counts the trailing zeros of a value.
+/// @param value The value, not zero.
+/// @return The number of trailing zeros.
+inline auto trailing_zeros(std::uint64_t value) noexcept -> unsigned
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned count = 0;
+    for (; (value & 1U) == 0; value >>= 1U) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// @brief Writes values bit by bit, most significant first.
+class bit_writer
+{
+public:
+    /// @brief Appends the lowest bits of a value.
+    /// @param value The value.
+    /// @param count The number of bits, up to 64.
+    void write(std::uint64_t value, unsigned count)
+    {
+        if (count > 32) {
+            this->write(value >> 32U, count - 32);
+            count = 32;
+        }
+        if (count == 0) {
+            return;
+        }
+        m_buffer = (m_buffer << count) | (value & ((std::uint64_t(1) << count) - 1));
+        m_count += count;
+        while (m_count >= 8) {
+            m_count -= 8;
+            m_bytes.push_back(static_cast<unsigned char>(m_buffer >> m_count));
+        }
+    }
+
+    /// @brief Pads the last byte with zeros.
+    void align()
+    {
+        if (m_count > 0) {
+            this->write(0, 8 - m_count);
+        }
+    }
+
+    /// @brief Returns the bytes written.
+    /// @return The bytes.
+    auto bytes() -> std::vector<unsigned char> & { return m_bytes; }
+
+private:
+    /// The bytes written.
+    std::vector<unsigned char> m_bytes;
+    /// The bits not yet written to the bytes.
+    std::uint64_t m_buffer{0};
+    /// The number of bits in the buffer.
+    unsigned m_count{0};
+};
+
+/// @brief Reads values bit by bit, most significant first.
+class bit_reader
+{
+public:
+    /// @brief Creates a reader.
+    /// @param data The bytes.
+    /// @param size The number of bytes.
+    bit_reader(const unsigned char *data, std::size_t size) noexcept
+        : m_data(data)
+        , m_end(data + size)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Reads a value.
+    /// @param count The number of bits, up to 64.
+    /// @return The value, zero past the end of the bytes.
+    auto read(unsigned count) noexcept -> std::uint64_t
+    {
+        if (count > 32) {
+            const std::uint64_t high = this->read(count - 32);
+            return (high << 32U) | this->read(32);
+        }
+        if (count == 0) {
+            return 0;
+        }
+        while (m_count < count) {
+            m_buffer = (m_buffer << 8U) | ((m_data < m_end) ? *m_data++ : 0U);
+            m_count += 8;
+        }
+        m_count -= count;
+        return (m_buffer >> m_count) & ((std::uint64_t(1) << count) - 1);
+    }
+
+    /// @brief Reads a single bit.
+    /// @return The bit.
+    auto bit() noexcept -> bool { return this->read(1) != 0; }
+
+private:
+    /// The next byte.
+    const unsigned char *m_data;
+    /// The end of the bytes.
+    const unsigned char *m_end;
+    /// The bits read from the bytes, not yet returned.
+    std::uint64_t m_buffer{0};
+    /// The number of bits in the buffer.
+    unsigned m_count{0};
+};
+
+/// @brief Encodes a sequence of integers with the delta of their deltas,
+/// which takes a single bit when the sequence grows linearly.
+struct delta_coder {
+    /// The previous value.
+    std::uint64_t previous{0};
+    /// The previous delta.
+    std::uint64_t delta{0};
+
+    /// @brief Encodes a value.
+    /// @param out Where to write.
+    /// @param value The value.
+    void encode(bit_writer &out, std::uint64_t value)
+    {
+        const std::uint64_t next = value - previous;
+        const std::uint64_t dod  = next - delta;
+        // Zig-zag, so that small negative values are small too.
+        const std::uint64_t zz   = (dod << 1U) ^ (std::uint64_t(0) - (dod >> 63U));
+        if (zz == 0) {
+            out.write(0, 1);
+        } else if (zz < (std::uint64_t(1) << 7U)) {
+            out.write(0x2, 2), out.write(zz, 7);
+        } else if (zz < (std::uint64_t(1) << 12U)) {
+            out.write(0x6, 3), out.write(zz, 12);
+        } else if (zz < (std::uint64_t(1) << 20U)) {
+            out.write(0xE, 4), out.write(zz, 20);
+        } else {
+            out.write(0xF, 4), out.write(zz, 64);
+        }
+        previous = value, delta = next;
+    }
+
+    /// @brief Decodes a value.
+    /// @param in Where to read.
+    /// @return The value.
+    auto decode(bit_reader &in) -> std::uint64_t
+    {
+        std::uint64_t zz = 0;
+        if (in.bit()) {
+            if (!in.bit()) {
+                zz = in.read(7);
+            } else if (!in.bit()) {
+                zz = in.read(12);
+            } else if (!in.bit()) {
+                zz = in.read(20);
+            } else {
+                zz = in.read(64);
+            }
+        }
+        const std::uint64_t dod = (zz >> 1U) ^ (std::uint64_t(0) - (zz & 1U));
+        delta += dod;
+        previous += delta;
+        return previous;
+    }
+};
+
+/// @brief Encodes a sequence of values with the XOR of their bit patterns,
+/// storing only the bits between the leading and the trailing zeros.
+/// @tparam T The type of the values.
+template <class T>
+struct xor_coder {
+    /// The width of the values, in bits.
+    static constexpr unsigned width = 8 * sizeof(T);
+    /// The bit pattern of the previous value.
+    std::uint64_t previous{0};
+    /// The leading zeros of the last window.
+    unsigned leading{width};
+    /// The trailing zeros of the last window.
+    unsigned trailing{0};
+
+    /// @brief Encodes a value.
+    /// @param out Where to write.
+    /// @param value The value.
+    void encode(bit_writer &out, const T &value)
+    {
+        const std::uint64_t bits = to_bits(value);
+        const std::uint64_t diff = bits ^ previous;
+        previous                 = bits;
+        if (diff == 0) {
+            out.write(0, 1);
+            return;
+        }
+        const unsigned lead  = std::min(leading_zeros(diff, width), 31U);
+        const unsigned trail = trailing_zeros(diff);
+        if ((leading < width) && (lead >= leading) && (trail >= trailing)) {
+            // Reuse the previous window.
+            out.write(0x2, 2);
+            out.write(diff >> trailing, width - leading - trailing);
+            return;
+        }
+        leading = lead, trailing = trail;
+        out.write(0x3, 2);
+        out.write(lead, 5);
+        out.write(width - lead - trail - 1, 6);
+        out.write(diff >> trail, width - lead - trail);
+    }
+
+    /// @brief Decodes a value.
+    /// @param in Where to read.
+    /// @return The value.
+    auto decode(bit_reader &in) -> T
+    {
+        if (in.bit()) {
+            if (in.bit()) {
+                leading  = static_cast<unsigned>(in.read(5));
+                trailing = width - leading - static_cast<unsigned>(in.read(6)) - 1;
+            }
+            previous ^= in.read(width - leading - trailing) << trailing;
+        }
+        return from_bits<T>(previous);
+    }
+};
+
+/// @brief The encoding of the time and of the columns of a trajectory, shared
+/// by the encoder and the decoder.
+/// @tparam Value The type of the values of the state.
+/// @tparam Time The datatype used to hold time.
+template <class Value, class Time>
+class row_coder
+{
+public:
+    /// @brief Creates the coder.
+    /// @param bounds The error bound of each column, zero for lossless columns.
+    explicit row_coder(std::vector<double> bounds = std::vector<double>())
+        : m_bounds(std::move(bounds))
+        , m_values(m_bounds.size())
+        , m_integers(m_bounds.size())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the error bounds.
+    /// @return The error bounds.
+    auto bounds() const -> const std::vector<double> & { return m_bounds; }
+
+    /// @brief Encodes a row.
+    /// @param out Where to write.
+    /// @param x The state vector.
+    /// @param t The time.
+    template <class State>
+    void encode(bit_writer &out, const State &x, const Time &t)
+    {
+        m_time.encode(out, to_bits(t));
+        for (std::size_t i = 0; i < m_bounds.size(); ++i) {
+            if (m_bounds[i] > 0) {
+                const auto step = static_cast<double>(x[i]) / (2 * m_bounds[i]);
+                m_integers[i].encode(out, static_cast<std::uint64_t>(std::llround(step)));
+            } else {
+                m_values[i].encode(out, static_cast<Value>(x[i]));
+            }
+        }
+    }
+
+    /// @brief Decodes a row.
+    /// @param in Where to read.
+    /// @param x The state vector, with one element per column.
+    /// @param t The time.
+    template <class State>
+    void decode(bit_reader &in, State &x, Time &t)
+    {
+        t = from_bits<Time>(m_time.decode(in));
+        for (std::size_t i = 0; i < m_bounds.size(); ++i) {
+            if (m_bounds[i] > 0) {
+                const auto step = static_cast<std::int64_t>(m_integers[i].decode(in));
+                x[i]            = static_cast<Value>(static_cast<double>(step) * (2 * m_bounds[i]));
+            } else {
+                x[i] = m_values[i].decode(in);
+            }
+        }
+    }
+
+private:
+    /// The error bound of each column.
+    std::vector<double> m_bounds;
+    /// The encoding of the time.
+    delta_coder m_time;
+    /// The encoding of the lossless columns.
+    std::vector<xor_coder<Value>> m_values;
+    /// The encoding of the lossy columns.
+    std::vector<delta_coder> m_integers;
+};
+
+/// @brief Writes a 32 bits value in little-endian order.
+/// @param out Where to write.
+/// @param value The value.
+inline void store32(std::vector<unsigned char> &out, std::uint32_t value)
+{
+    for (unsigned i = 0; i < 4; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+/// @brief Reads a 32 bits value written in little-endian order.
+/// @param data Where to read.
+/// @return The value.
+inline auto load32(const unsigned char *data) noexcept -> std::uint32_t
+{
+    std::uint32_t value = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace compression
+
+/// @brief Observer that compresses the trajectory into a stream of bytes,
+/// see `compression.hpp` for the format.
+///
+/// @details The rows are encoded as they arrive, and every `block_rows` rows
+/// the block is handed to the sink (e.g., writing it to a file), together with
+/// the header before the first block. `flush()` hands over the partial block.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class ObserverCompress : public Observer<State, Time>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+    /// @brief The type of the sink receiving the bytes.
+    using sink_type  = std::function<void(const unsigned char *, std::size_t)>;
+
+    /// @brief Creates the observer.
+    /// @param sink The function receiving the bytes.
+    /// @param bounds The error bound of each column, zero for lossless
+    /// columns, if empty all the columns are lossless. The values of the lossy
+    /// columns must be finite.
+    /// @param block_rows The number of rows of a block.
+    explicit ObserverCompress(
+        sink_type sink,
+        std::vector<double> bounds = std::vector<double>(),
+        std::size_t block_rows      = 1024)
+        : m_sink(std::move(sink))
+        , m_coder(std::move(bounds))
+        , m_block_rows(std::max<std::size_t>(block_rows, 1))
+        , m_rows(0)
+        , m_started(false)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Hands the partial block to the sink.
+    ~ObserverCompress()
+    {
+        try {
+            this->flush();
+        } catch (...) {
+            // A destructor must not throw, call `flush()` to see the errors.
+        }
+    }
+
+    /// @brief Copy constructor, deleted as the observer owns the stream.
+    ObserverCompress(const ObserverCompress &other) = delete;
+
+    /// @brief Move constructor, deleted as the observer owns the stream.
+    ObserverCompress(ObserverCompress &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the observer owns the stream.
+    /// @return Reference to the observer.
+    auto operator=(const ObserverCompress &other) -> ObserverCompress & = delete;
+
+    /// @brief Move assignment operator, deleted as the observer owns the stream.
+    /// @return Reference to the observer.
+    auto operator=(ObserverCompress &&other) -> ObserverCompress & = delete;
+
+    /// @brief Encodes a row.
+    /// @param x The state vector.
+    /// @param t The time.
+    void operator()(const State &x, const Time &t)
+    {
+        if (!m_started) {
+            this->write_header(x.size());
+        }
+        m_coder.encode(m_bits, x, t);
+        if (++m_rows == m_block_rows) {
+            this->flush();
+        }
+    }
+
+    /// @brief Hands the rows encoded so far to the sink.
+    void flush()
+    {
+        if (m_rows == 0) {
+            return;
+        }
+        m_bits.align();
+        auto &payload = m_bits.bytes();
+        std::vector<unsigned char> header;
+        compression::store32(header, static_cast<std::uint32_t>(m_rows));
+        compression::store32(header, static_cast<std::uint32_t>(payload.size()));
+        m_sink(header.data(), header.size());
+        m_sink(payload.data(), payload.size());
+        payload.clear();
+        m_rows = 0;
+    }
+
+private:
+    /// @brief Writes the header of the stream.
+    /// @param columns The dimension of the state.
+    void write_header(std::size_t columns)
+    {
+        if (m_coder.bounds().empty()) {
+            m_coder = compression::row_coder<value_type, Time>(std::vector<double>(columns, 0.));
+        }
+        if (m_coder.bounds().size() != columns) {
+            throw std::runtime_error("The number of error bounds does not match the dimension of the state.");
+        }
+        std::vector<unsigned char> header(compression::magic, compression::magic + sizeof(compression::magic));
+        header.push_back(static_cast<unsigned char>(sizeof(Time)));
+        header.push_back(static_cast<unsigned char>(sizeof(value_type)));
+        header.push_back(0), header.push_back(0);
+        compression::store32(header, static_cast<std::uint32_t>(columns));
+        for (const double bound : m_coder.bounds()) {
+            const std::uint64_t bits = compression::to_bits(bound);
+            compression::store32(header, static_cast<std::uint32_t>(bits));
+            compression::store32(header, static_cast<std::uint32_t>(bits >> 32U));
+        }
+        m_sink(header.data(), header.size());
+        m_started = true;
+    }
+
+    /// The function receiving the bytes.
+    sink_type m_sink;
+    /// The encoding of the rows.
+    compression::row_coder<value_type, Time> m_coder;
+    /// The bits of the current block.
+    compression::bit_writer m_bits;
+    /// The number of rows of a block.
+    std::size_t m_block_rows;
+    /// The number of rows in the current block.
+    std::size_t m_rows;
+    /// If the header was written.
+    bool m_started;
+};
+
+/// @brief Decodes a stream written by `ObserverCompress`, as its bytes arrive.
+/// @tparam Value The type of the values of the state.
+/// @tparam Time The datatype used to hold time.
+template <class Value, class Time>
+class trajectory_decoder
+{
+public:
+    /// @brief Appends bytes of the stream.
+    /// @param data The bytes.
+    /// @param size The number of bytes.
+    void feed(const unsigned char *data, std::size_t size)
+    {
+        // Drop the bytes already decoded, before they pile up.
+        if (m_offset > (m_pending.size() / 2)) {
+            m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(m_offset));
+            m_offset = 0;
+        }
+        m_pending.insert(m_pending.end(), data, data + size);
+    }
+
+    /// @brief Returns the number of columns, known once the header arrived.
+    /// @return The number of columns.
+    auto columns() const noexcept -> std::size_t { return m_coder.bounds().size(); }
+
+    /// @brief Decodes the next row, if its block arrived.
+    /// @param x The state vector, with one element per column.
+    /// @param t The time.
+    /// @return true if a row was decoded.
+    template <class State>
+    auto next(State &x, Time &t) -> bool
+    {
+        if ((m_rows == 0) && !this->next_block()) {
+            return false;
+        }
+        m_coder.decode(m_reader, x, t);
+        --m_rows;
+        return true;
+    }
+
+private:
+    /// @brief Reads the header, if not read yet, and the next block.
+    /// @return true if the whole block arrived.
+    auto next_block() -> bool
+    {
+        const unsigned char *data = m_pending.data() + m_offset;
+        const std::size_t size    = m_pending.size() - m_offset;
+        if (!m_started) {
+            if (size < 16) {
+                return false;
+            }
+            if (std::memcmp(data, compression::magic, sizeof(compression::magic)) != 0) {
+                throw std::runtime_error("The stream is not a compressed trajectory.");
+            }
+            if ((data[8] != sizeof(Time)) || (data[9] != sizeof(Value))) {
+                throw std::runtime_error("The stream stores values of a different size.");
+            }
+            const std::size_t columns = compression::load32(data + 12);
+            if (size < (16 + (8 * columns))) {
+                return false;
+            }
+            std::vector<double> bounds(columns);
+            for (std::size_t i = 0; i < columns; ++i) {
+                const unsigned char *bound = data + 16 + (8 * i);
+                bounds[i]                  = compression::from_bits<double>(
+                    compression::load32(bound) | (std::uint64_t(compression::load32(bound + 4)) << 32U));
+            }
+            m_coder   = compression::row_coder<Value, Time>(std::move(bounds));
+            m_started = true;
+            m_offset += 16 + (8 * columns);
+            return this->next_block();
+        }
+        if (size < 8) {
+            return false;
+        }
+        const std::size_t rows  = compression::load32(data);
+        const std::size_t bytes = compression::load32(data + 4);
+        if (size < (8 + bytes)) {
+            return false;
+        }
+        // Keep the block aside, as feeding more bytes moves the pending ones.
+        m_block.assign(data + 8, data + 8 + bytes);
+        m_reader = compression::bit_reader(m_block.data(), m_block.size());
+        m_rows   = rows;
+        m_offset += 8 + bytes;
+        return m_rows > 0;
+    }
+
+    /// The bytes received, and not dropped yet.
+    std::vector<unsigned char> m_pending;
+    /// The first byte not decoded.
+    std::size_t m_offset{0};
+    /// The decoding of the rows.
+    compression::row_coder<Value, Time> m_coder;
+    /// The current block.
+    std::vector<unsigned char> m_block;
+    /// The reader of the current block.
+    compression::bit_reader m_reader{nullptr, 0};
+    /// The rows left in the current block.
+    std::size_t m_rows{0};
+    /// If the header was read.
+    bool m_started{false};
+};
+
+} // namespace numint::detail
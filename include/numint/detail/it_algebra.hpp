@@ -8,31 +8,309 @@
 
 #pragma once
 
+#include "numint/detail/trace.hpp"
+#include "numint/detail/type_traits.hpp"
+
+#ifdef NUMINT_PARALLEL_ALGEBRA
+#include "numint/detail/parallel.hpp"
+#endif
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Tells the compiler that the iterations of the following loop are
+/// independent, so that it can be vectorized without runtime alias checks.
+#if defined(__clang__)
+#define NUMINT_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define NUMINT_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define NUMINT_IVDEP __pragma(loop(ivdep))
+#else
+#define NUMINT_IVDEP
+#endif
 
 namespace numint::detail::it_algebra
 {
 
+namespace detail
+{
+
+/// @brief Returns the absolute value of an element, through argument
+/// dependent lookup so that packs of lanes provide their own overload.
+/// @param value The element.
+/// @return The absolute value.
+template <class V>
+constexpr auto abs_value(const V &value) noexcept
+{
+    using std::abs;
+    return abs(value);
+}
+
+/// @brief Reduces an element to a scalar by taking its largest component.
+/// Scalars are returned as they are, packs of lanes overload this function.
+/// @param value The element.
+/// @return The largest component.
+template <class V>
+constexpr auto reduce_max(const V &value) noexcept -> V
+{
+    return value;
+}
+
+/// @brief Checks if an iterator walks over a contiguous array of floating
+/// point values, either because it is a pointer or a `std::vector` iterator.
+/// @tparam It The iterator type.
+template <class It, class = void>
+struct is_contiguous_floating : std::false_type {
+};
+
+/// @brief Checks if an iterator walks over a contiguous array of floating
+/// point values, either because it is a pointer or a `std::vector` iterator.
+/// @tparam It The iterator type.
+template <class It>
+struct is_contiguous_floating<It, std::void_t<typename std::iterator_traits<It>::value_type>>
+    : std::bool_constant<
+          std::is_floating_point_v<typename std::iterator_traits<It>::value_type> &&
+          (std::is_pointer_v<It> ||
+           std::is_same_v<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator> ||
+           std::is_same_v<It, typename std::vector<typename std::iterator_traits<It>::value_type>::const_iterator>)> {
+};
+
+/// @brief Checks if an argument of the scaled sums can be handled by the
+/// contiguous kernels, i.e., it is either a scalar or a contiguous iterator.
+/// @tparam Arg The argument type.
+template <class Arg>
+constexpr inline bool is_kernel_arg_v = std::is_arithmetic_v<Arg> || is_contiguous_floating<Arg>::value;
+
+/// @brief Turns an argument of the scaled sums into the one used by the
+/// contiguous kernels: scalars are kept, iterators become raw pointers.
+/// @param arg The argument.
+/// @return The scalar, or the pointer to the first element.
+template <class Arg>
+inline auto to_kernel_arg(Arg arg) noexcept
+{
+    if constexpr (std::is_arithmetic_v<Arg>) {
+        return arg;
+    } else {
+        return &*arg;
+    }
+}
+
+/// @brief Checks that an argument does not partially overlap with the output
+/// range. A range which coincides with the output is fine, since each
+/// iteration only reads and writes its own element.
+/// @param y Pointer to the output range.
+/// @param n The number of elements.
+/// @param arg The argument, scalars never overlap.
+/// @return true if the argument is a scalar, the output itself, or points to a disjoint range.
+template <class V, class Arg>
+inline auto is_disjoint(const V *y, std::size_t n, Arg arg) noexcept -> bool
+{
+    if constexpr (std::is_pointer_v<Arg>) {
+        const std::less<const void *> less;
+        return (static_cast<const void *>(arg) == static_cast<const void *>(y)) ||
+               !less(static_cast<const void *>(arg), static_cast<const void *>(y + n)) ||
+               !less(static_cast<const void *>(y), static_cast<const void *>(arg + n));
+    } else {
+        (void)y, (void)n, (void)arg;
+        return true;
+    }
+}
+
+/// @brief Base case of the indexed accumulation of scaled terms.
+/// @param ... Unused parameters for recursion termination.
+constexpr void add_indexed(...) noexcept
+{
+    // Base case: Do nothing, recursion stops here.
+}
+
+/// @brief Adds the i-th element of each scaled term, in the same order of
+/// `add_helper`, so that the contiguous kernels give identical results.
+/// @param y The value to accumulate the scaled terms into.
+/// @param i The index of the element.
+/// @param op Operation to perform on the scalar and the element.
+/// @param a Scalar value to scale the current term.
+/// @param x Pointer to the current term.
+/// @param args Remaining scalars and pointers.
+template <class V, class Op, class T, class P, class... Args>
+constexpr void add_indexed(V &y, std::size_t i, Op op, T a, P *x, Args... args) noexcept
+{
+    y += op(a, x[i]);
+    add_indexed(y, i, op, args...);
+}
+
+/// @brief Contiguous kernel for the scaled sums: a plain indexed loop that
+/// compilers vectorize with whichever instruction set the build targets.
+/// @param y Pointer to the output range.
+/// @param n The number of elements.
+/// @param op Operation to apply for element-wise computation.
+/// @param a First scalar value.
+/// @param x Pointer to the first range.
+/// @param args Remaining scalars and pointers.
+template <bool Accumulate, class V, class Op, class T, class P, class... Args>
+inline void scaled_sum_kernel(V *y, std::size_t n, Op op, T a, P *x, Args... args) noexcept
+{
+    if (is_disjoint(y, n, x) && (is_disjoint(y, n, args) && ...)) {
+        // The output does not partially alias the inputs, the iterations are independent.
+        NUMINT_IVDEP
+        for (std::size_t i = 0; i < n; ++i) {
+            V value = Accumulate ? y[i] + op(a, x[i]) : op(a, x[i]);
+            add_indexed(value, i, op, args...);
+            y[i] = value;
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            V value = Accumulate ? y[i] + op(a, x[i]) : op(a, x[i]);
+            add_indexed(value, i, op, args...);
+            y[i] = value;
+        }
+    }
+}
+
+/// @brief Contiguous kernel for the error reductions, it keeps four partial
+/// maxima to break the dependency between consecutive iterations.
+/// @param a0 Pointer to the first range.
+/// @param a1 Pointer to the second range.
+/// @param n The number of elements.
+/// @param error Function computing the error between two elements.
+/// @return Maximum error.
+template <class T, class V, class Error>
+inline auto max_error_kernel(const V *a0, const V *a1, std::size_t n, Error error) noexcept -> T
+{
+    T r0(std::numeric_limits<T>::epsilon()), r1(r0), r2(r0), r3(r0);
+    std::size_t i = 0;
+    for (; (i + 4) <= n; i += 4) {
+        r0 = std::max(r0, T(error(a0[i + 0], a1[i + 0])));
+        r1 = std::max(r1, T(error(a0[i + 1], a1[i + 1])));
+        r2 = std::max(r2, T(error(a0[i + 2], a1[i + 2])));
+        r3 = std::max(r3, T(error(a0[i + 3], a1[i + 3])));
+    }
+    for (; i < n; ++i) {
+        r0 = std::max(r0, T(error(a0[i], a1[i])));
+    }
+    return std::max(std::max(r0, r1), std::max(r2, r3));
+}
+
+/// @brief Moves an argument of the contiguous kernels forward, to the first
+/// element of a chunk: scalars are kept, pointers are advanced.
+/// @param arg The argument.
+/// @param first The index of the first element of the chunk.
+/// @return The scalar, or the pointer to the first element of the chunk.
+template <class Arg>
+constexpr auto advance_kernel_arg(Arg arg, std::size_t first) noexcept -> Arg
+{
+    if constexpr (std::is_pointer_v<Arg>) {
+        return arg + first;
+    } else {
+        (void)first;
+        return arg;
+    }
+}
+
+/// @brief Runs the scaled sums kernel. With `NUMINT_PARALLEL_ALGEBRA`, huge
+/// ranges are split between the threads of the shared pool, unless the output
+/// partially aliases the inputs.
+/// @param y Pointer to the output range.
+/// @param n The number of elements.
+/// @param op Operation to apply for element-wise computation.
+/// @param a First scalar value.
+/// @param x Pointer to the first range.
+/// @param args Remaining scalars and pointers.
+template <bool Accumulate, class V, class Op, class T, class P, class... Args>
+inline void scaled_sum(V *y, std::size_t n, Op op, T a, P *x, Args... args) noexcept
+{
+#ifdef NUMINT_PARALLEL_ALGEBRA
+    if ((n >= NUMINT_PARALLEL_THRESHOLD) && is_disjoint(y, n, x) && (is_disjoint(y, n, args) && ...)) {
+        numint::detail::parallel_chunks<V>(n, [&](std::size_t first, std::size_t last) {
+            scaled_sum_kernel<Accumulate>(
+                y + first, last - first, op, a, x + first, advance_kernel_arg(args, first)...);
+        });
+        return;
+    }
+#endif
+    scaled_sum_kernel<Accumulate>(y, n, op, a, x, args...);
+}
+
+/// @brief Runs the error reduction kernel. With `NUMINT_PARALLEL_ALGEBRA`,
+/// huge ranges are split between the threads of the shared pool.
+/// @param a0 Pointer to the first range.
+/// @param a1 Pointer to the second range.
+/// @param n The number of elements.
+/// @param error Function computing the error between two elements.
+/// @return Maximum error.
+template <class T, class V, class Error>
+inline auto max_error(const V *a0, const V *a1, std::size_t n, Error error) noexcept -> T
+{
+#ifdef NUMINT_PARALLEL_ALGEBRA
+    if (n >= NUMINT_PARALLEL_THRESHOLD) {
+        // The maximum does not depend on the order, so the result is the same.
+        T ret(std::numeric_limits<T>::epsilon());
+        std::mutex mutex;
+        numint::detail::parallel_chunks<V>(n, [&](std::size_t first, std::size_t last) {
+            const T partial = max_error_kernel<T>(a0 + first, a1 + first, last - first, error);
+            std::lock_guard<std::mutex> lock(mutex);
+            ret = std::max(ret, partial);
+        });
+        return ret;
+    }
+#endif
+    return max_error_kernel<T>(a0, a1, n, error);
+}
+
+/// @brief Computes the length of the shortest between two contiguous ranges.
+/// @param a0_first Iterator to the first element of range 1.
+/// @param a0_last Iterator to the last element of range 1.
+/// @param a1_first Iterator to the first element of range 2.
+/// @param a1_last Iterator to the last element of range 2.
+/// @return The number of elements both ranges have.
+template <class It>
+inline auto common_length(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, std::min(a0_last - a0_first, a1_last - a1_first)));
+}
+
+} // namespace detail
+
 /// @brief Computes the maximum absolute difference between elements in two ranges.
 /// @param a0_first Iterator to the first element of range 1.
 /// @param a0_last Iterator to the last element of range 1.
 /// @param a1_first Iterator to the first element of range 2.
 /// @param a1_last Iterator to the last element of range 2.
 /// @return Maximum absolute difference.
+/// @note `T` is the scalar type of the result, when the elements are packs of
+/// lanes the maximum is taken across all the lanes.
 template <class T, class It>
 constexpr auto max_abs_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
-    // Initialize the value to epsilon, to prevent small truncation error when
-    // using the returned value.
-    T ret(std::numeric_limits<T>::epsilon());
-    // Find the max difference.
-    while ((a0_first != a0_last) && (a1_first != a1_last)) {
-        ret = std::max(ret, std::abs(*a0_first - *a1_first));
-        ++a0_first, ++a1_first;
+    using detail::abs_value;
+    using detail::reduce_max;
+    // Contiguous floating point ranges go through the unrolled kernel.
+    if constexpr (detail::is_contiguous_floating<It>::value) {
+        const std::size_t n = detail::common_length(a0_first, a0_last, a1_first, a1_last);
+        if (n == 0) {
+            return std::numeric_limits<T>::epsilon();
+        }
+        return detail::max_error<T>(
+            &*a0_first, &*a1_first, n, [](auto v0, auto v1) { return std::abs(v0 - v1); });
+    } else {
+        // Initialize the value to epsilon, to prevent small truncation error when
+        // using the returned value.
+        T ret(std::numeric_limits<T>::epsilon());
+        // Find the max difference.
+        while ((a0_first != a0_last) && (a1_first != a1_last)) {
+            ret = std::max(ret, T(reduce_max(abs_value(*a0_first - *a1_first))));
+            ++a0_first, ++a1_first;
+        }
+        return ret;
     }
-    return ret;
 }
 
 /// @brief Computes the maximum relative difference between elements in two ranges.
@@ -44,15 +322,27 @@ constexpr auto max_abs_diff(It a0_first, It a0_last, It a1_first, It a1_last) no
 template <class T, class It>
 constexpr auto max_rel_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
-    // Initialize the value to epsilon, to prevent small truncation error when
-    // using the returned value.
-    T ret(std::numeric_limits<T>::epsilon());
-    // Find the max difference.
-    while ((a0_first != a0_last) && (a1_first != a1_last)) {
-        ret = std::max(ret, std::abs((*a0_first - *a1_first) / *a0_first));
-        ++a0_first, ++a1_first;
+    using detail::abs_value;
+    using detail::reduce_max;
+    // Contiguous floating point ranges go through the unrolled kernel.
+    if constexpr (detail::is_contiguous_floating<It>::value) {
+        const std::size_t n = detail::common_length(a0_first, a0_last, a1_first, a1_last);
+        if (n == 0) {
+            return std::numeric_limits<T>::epsilon();
+        }
+        return detail::max_error<T>(
+            &*a0_first, &*a1_first, n, [](auto v0, auto v1) { return std::abs((v0 - v1) / v0); });
+    } else {
+        // Initialize the value to epsilon, to prevent small truncation error when
+        // using the returned value.
+        T ret(std::numeric_limits<T>::epsilon());
+        // Find the max difference.
+        while ((a0_first != a0_last) && (a1_first != a1_last)) {
+            ret = std::max(ret, T(reduce_max(abs_value((*a0_first - *a1_first) / *a0_first))));
+            ++a0_first, ++a1_first;
+        }
+        return ret;
     }
-    return ret;
 }
 
 /// @brief Computes the maximum of absolute and relative differences between two ranges.
@@ -64,15 +354,30 @@ constexpr auto max_rel_diff(It a0_first, It a0_last, It a1_first, It a1_last) no
 template <class T, class It>
 constexpr auto max_comb_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
-    // Initialize the value to epsilon, to prevent small truncation error when
-    // using the returned value.
-    T ret(std::numeric_limits<T>::epsilon());
-    // Find the max difference.
-    while ((a0_first != a0_last) && (a1_first != a1_last)) {
-        ret = std::max(std::max(ret, std::abs((*a0_first - *a1_first) / *a0_first)), std::abs(*a0_first - *a1_first));
-        ++a0_first, ++a1_first;
+    using detail::abs_value;
+    using detail::reduce_max;
+    // Contiguous floating point ranges go through the unrolled kernel.
+    if constexpr (detail::is_contiguous_floating<It>::value) {
+        const std::size_t n = detail::common_length(a0_first, a0_last, a1_first, a1_last);
+        if (n == 0) {
+            return std::numeric_limits<T>::epsilon();
+        }
+        return detail::max_error<T>(&*a0_first, &*a1_first, n, [](auto v0, auto v1) {
+            return std::max(std::abs(v0 - v1), std::abs((v0 - v1) / v0));
+        });
+    } else {
+        // Initialize the value to epsilon, to prevent small truncation error when
+        // using the returned value.
+        T ret(std::numeric_limits<T>::epsilon());
+        // Find the max difference.
+        while ((a0_first != a0_last) && (a1_first != a1_last)) {
+            ret = std::max(
+                std::max(ret, T(reduce_max(abs_value((*a0_first - *a1_first) / *a0_first)))),
+                T(reduce_max(abs_value(*a0_first - *a1_first))));
+            ++a0_first, ++a1_first;
+        }
+        return ret;
     }
-    return ret;
 }
 
 namespace detail
@@ -87,14 +392,15 @@ constexpr void add_helper(...) noexcept
 }
 
 /// @brief Helper function to recursively add scaled terms without modifying iterators prematurely.
-/// @param y The value to accumulate the scaled terms into.
+/// @param y The value to accumulate the scaled terms into, its type may differ
+/// from the one of the scalars (e.g., a pack of lanes scaled by a time step).
 /// @param op Operation to perform on the scalar and dereferenced iterator value.
 /// @param a Scalar value to scale the current term.
 /// @param x Iterator corresponding to the scalar.
 /// @param args Remaining scalars and iterators.
 /// @note This function is called recursively to handle multiple terms.
-template <class T, class It, class Op, class... Args>
-constexpr void add_helper(T &y, Op op, T a, It &x, Args &...args) noexcept
+template <class Y, class T, class It, class Op, class... Args>
+constexpr void add_helper(Y &y, Op op, T a, It &x, Args &...args) noexcept
 {
     // Add the current scaled term.
     y += op(a, *x++);
@@ -115,13 +421,23 @@ constexpr void add_helper(T &y, Op op, T a, It &x, Args &...args) noexcept
 template <class OutIt, class T, class InIt, class Op, class... Args>
 constexpr void sum_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Args... args) noexcept
 {
-    while (y_first != y_last) {
-        // Add the current scaled term.
-        *y_first = op(a, *x++);
-        // Recursively add the remaining scalars and iterators.
-        detail::add_helper(*y_first, op, args...);
-        // Increment the output iterator.
-        ++y_first;
+    // Contiguous floating point ranges go through the indexed kernel.
+    if constexpr (
+        detail::is_contiguous_floating<OutIt>::value && detail::is_contiguous_floating<InIt>::value &&
+        (detail::is_kernel_arg_v<Args> && ...)) {
+        if (y_first != y_last) {
+            detail::scaled_sum<false>(
+                &*y_first, static_cast<std::size_t>(y_last - y_first), op, a, &*x, detail::to_kernel_arg(args)...);
+        }
+    } else {
+        while (y_first != y_last) {
+            // Add the current scaled term.
+            *y_first = op(a, *x++);
+            // Recursively add the remaining scalars and iterators.
+            detail::add_helper(*y_first, op, args...);
+            // Increment the output iterator.
+            ++y_first;
+        }
     }
 }
 
@@ -136,14 +452,291 @@ constexpr void sum_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Ar
 template <class OutIt, class T, class InIt, class Op, class... Args>
 constexpr void accumulate_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Args... args) noexcept
 {
-    while (y_first != y_last) {
-        // Add the current scaled term.
-        *y_first += op(a, *x++);
-        // Recursively add the remaining scalars and iterators.
-        detail::add_helper(*y_first, op, args...);
-        // Increment the output iterator.
-        ++y_first;
+    // Contiguous floating point ranges go through the indexed kernel.
+    if constexpr (
+        detail::is_contiguous_floating<OutIt>::value && detail::is_contiguous_floating<InIt>::value &&
+        (detail::is_kernel_arg_v<Args> && ...)) {
+        if (y_first != y_last) {
+            detail::scaled_sum<true>(
+                &*y_first, static_cast<std::size_t>(y_last - y_first), op, a, &*x, detail::to_kernel_arg(args)...);
+        }
+    } else {
+        while (y_first != y_last) {
+            // Add the current scaled term.
+            *y_first += op(a, *x++);
+            // Recursively add the remaining scalars and iterators.
+            detail::add_helper(*y_first, op, args...);
+            // Increment the output iterator.
+            ++y_first;
+        }
+    }
+}
+
+namespace detail
+{
+
+/// @brief Base case of the accumulation of the I-th element of each scaled term.
+/// @param y Unused, the value the terms are accumulated into.
+/// @param op Unused, the operation.
+template <std::size_t I, class V, class Op>
+constexpr void add_element(V &y, Op op) noexcept
+{
+    // Base case: Do nothing, recursion stops here.
+    (void)y, (void)op;
+}
+
+/// @brief Adds the I-th element of each scaled term, in the same order of
+/// `add_helper`, so that the unrolled code gives identical results.
+/// @param y The value to accumulate the scaled terms into.
+/// @param op Operation to perform on the scalar and the element.
+/// @param a Scalar value to scale the current term.
+/// @param x The current term.
+/// @param args Remaining scalars and states.
+template <std::size_t I, class V, class Op, class T, class X, class... Args>
+constexpr void add_element(V &y, Op op, T a, const X &x, const Args &...args) noexcept
+{
+    y += op(a, x[I]);
+    add_element<I>(y, op, args...);
+}
+
+/// @brief Computes the I-th element of a scaled sum. The element is computed
+/// in a local value, so that the output can also appear among the terms.
+/// @param y The output state.
+/// @param op Operation to perform on the scalars and the elements.
+/// @param a First scalar value.
+/// @param x First state.
+/// @param args Remaining scalars and states.
+template <bool Accumulate, std::size_t I, class Y, class Op, class T, class X, class... Args>
+constexpr void sum_element(Y &y, Op op, T a, const X &x, const Args &...args) noexcept
+{
+    using V = std::remove_reference_t<decltype(y[I])>;
+    V value = Accumulate ? V(y[I] + op(a, x[I])) : V(op(a, x[I]));
+    add_element<I>(value, op, args...);
+    y[I] = value;
+}
+
+/// @brief Fully unrolled scaled sum, for states whose size is known at compile time.
+/// @param y The output state.
+/// @param op Operation to perform on the scalars and the elements.
+/// @param a First scalar value.
+/// @param x First state.
+/// @param args Remaining scalars and states.
+template <bool Accumulate, class Y, class Op, class T, class X, class... Args, std::size_t... I>
+constexpr void
+unrolled_scaled_sum(std::index_sequence<I...>, Y &y, Op op, T a, const X &x, const Args &...args) noexcept
+{
+    (sum_element<Accumulate, I>(y, op, a, x, args...), ...);
+}
+
+/// @brief Fully unrolled error reduction, for states whose size is known at compile time.
+/// @param a0 The first state.
+/// @param a1 The second state.
+/// @param error Function computing the error between two elements.
+/// @return Maximum error.
+template <class T, class State, class Error, std::size_t... I>
+constexpr auto unrolled_max_error(std::index_sequence<I...>, const State &a0, const State &a1, Error error) noexcept
+    -> T
+{
+    T ret(std::numeric_limits<T>::epsilon());
+    ((ret = std::max(ret, T(error(a0[I], a1[I])))), ...);
+    return ret;
+}
+
+/// The largest states processed by fully unrolled code: larger ones go
+/// through the contiguous kernels, as unrolling makes the compile time grow
+/// with their size.
+constexpr std::size_t unroll_limit = 32;
+
+/// @brief Checks if a state is processed by fully unrolled code, i.e., its
+/// size is known at compile time, and within `unroll_limit`.
+/// @tparam State The type of the state.
+template <class State, class = void>
+struct is_unrolled : std::false_type {
+};
+
+/// @brief Checks if a state is processed by fully unrolled code, i.e., its
+/// size is known at compile time, and within `unroll_limit`.
+/// @tparam State The type of the state.
+template <class State>
+struct is_unrolled<State, std::enable_if_t<numint::detail::has_static_size_v<State>>>
+    : std::bool_constant<(std::tuple_size<std::remove_cv_t<State>>::value <= unroll_limit)> {
+};
+
+/// @brief Helper variable template to check if a state is processed by fully unrolled code.
+/// @tparam State The type of the state.
+template <class State>
+constexpr inline bool is_unrolled_v = is_unrolled<State>::value;
+
+/// @brief Returns an iterator to the first element of a state. Contiguous
+/// states return a pointer, so that they reach the contiguous kernels whatever
+/// their iterator type is (e.g., a `std::vector` with a custom allocator).
+/// @param state The state.
+/// @return The iterator to the first element.
+template <class State>
+constexpr auto state_begin(State &state) noexcept
+{
+    if constexpr (numint::detail::has_data_v<State>) {
+        return state.data();
+    } else {
+        return state.begin();
+    }
+}
+
+/// @brief Returns an iterator past the last element of a state.
+/// @param state The state.
+/// @return The iterator past the last element.
+template <class State>
+constexpr auto state_end(State &state) noexcept
+{
+    if constexpr (numint::detail::has_data_v<State>) {
+        return state.data() + state.size();
+    } else {
+        return state.end();
+    }
+}
+
+/// @brief Turns an argument of the state-level operations into the one used
+/// by the iterator-based ones: scalars are kept, states become iterators.
+/// @param arg The argument.
+/// @return The scalar, or the iterator to the first element.
+template <class Arg>
+constexpr auto to_iterator_arg(const Arg &arg) noexcept
+{
+    if constexpr (numint::detail::is_state_v<Arg>) {
+        return state_begin(arg);
+    } else {
+        return arg;
+    }
+}
+
+} // namespace detail
+
+/// @brief Computes the maximum absolute difference between the elements of two states.
+/// @param a0 The first state.
+/// @param a1 The second state.
+/// @return Maximum absolute difference.
+/// @note Small states with a size known at compile time (e.g., `std::array`)
+/// are processed by fully unrolled code, the others by the iterator version.
+template <class T, class State>
+constexpr auto max_abs_diff(const State &a0, const State &a1) noexcept -> T
+{
+    using detail::abs_value;
+    using detail::reduce_max;
+    NUMINT_TRACE_BEGIN(algebra);
+    T error{};
+    if constexpr (detail::is_unrolled_v<State>) {
+        error = detail::unrolled_max_error<T>(
+            std::make_index_sequence<std::tuple_size_v<State>>(), a0, a1,
+            [](const auto &v0, const auto &v1) { return reduce_max(abs_value(v0 - v1)); });
+    } else {
+        error = max_abs_diff<T>(
+            detail::state_begin(a0), detail::state_end(a0), detail::state_begin(a1), detail::state_end(a1));
+    }
+    NUMINT_TRACE_END(algebra, "max_abs_diff");
+    return error;
+}
+
+/// @brief Computes the maximum relative difference between the elements of two states.
+/// @param a0 The first state.
+/// @param a1 The second state.
+/// @return Maximum relative difference.
+template <class T, class State>
+constexpr auto max_rel_diff(const State &a0, const State &a1) noexcept -> T
+{
+    using detail::abs_value;
+    using detail::reduce_max;
+    NUMINT_TRACE_BEGIN(algebra);
+    T error{};
+    if constexpr (detail::is_unrolled_v<State>) {
+        error = detail::unrolled_max_error<T>(
+            std::make_index_sequence<std::tuple_size_v<State>>(), a0, a1,
+            [](const auto &v0, const auto &v1) { return reduce_max(abs_value((v0 - v1) / v0)); });
+    } else {
+        error = max_rel_diff<T>(
+            detail::state_begin(a0), detail::state_end(a0), detail::state_begin(a1), detail::state_end(a1));
+    }
+    NUMINT_TRACE_END(algebra, "max_rel_diff");
+    return error;
+}
+
+/// @brief Computes the maximum of absolute and relative differences between the elements of two states.
+/// @param a0 The first state.
+/// @param a1 The second state.
+/// @return Maximum combined absolute and relative difference.
+template <class T, class State>
+constexpr auto max_comb_diff(const State &a0, const State &a1) noexcept -> T
+{
+    using detail::abs_value;
+    using detail::reduce_max;
+    NUMINT_TRACE_BEGIN(algebra);
+    T error{};
+    if constexpr (detail::is_unrolled_v<State>) {
+        error = detail::unrolled_max_error<T>(
+            std::make_index_sequence<std::tuple_size_v<State>>(), a0, a1, [](const auto &v0, const auto &v1) {
+                return std::max(T(reduce_max(abs_value((v0 - v1) / v0))), T(reduce_max(abs_value(v0 - v1))));
+            });
+    } else {
+        error = max_comb_diff<T>(
+            detail::state_begin(a0), detail::state_end(a0), detail::state_begin(a1), detail::state_end(a1));
+    }
+    NUMINT_TRACE_END(algebra, "max_comb_diff");
+    return error;
+}
+
+/// @brief Computes the element-wise sum of multiple scaled states into the output state.
+/// @param y The output state.
+/// @param op Operation to apply for element-wise computation (e.g., addition, subtraction).
+/// @param a First scalar value to scale the first state.
+/// @param x State corresponding to the first scalar.
+/// @param args Additional scalars and states.
+/// @note Small states with a size known at compile time (e.g., `std::array`)
+/// are processed by fully unrolled code, the others by the iterator version.
+template <
+    class State,
+    class Op,
+    class T,
+    class X,
+    class... Args,
+    std::enable_if_t<numint::detail::is_state_v<State>, int> = 0>
+constexpr void sum_operation(State &y, Op op, T a, const X &x, const Args &...args) noexcept
+{
+    NUMINT_TRACE_BEGIN(algebra);
+    if constexpr (detail::is_unrolled_v<State>) {
+        detail::unrolled_scaled_sum<false>(std::make_index_sequence<std::tuple_size_v<State>>(), y, op, a, x, args...);
+    } else {
+        sum_operation(
+            detail::state_begin(y), detail::state_end(y), op, a, detail::to_iterator_arg(x),
+            detail::to_iterator_arg(args)...);
+    }
+    NUMINT_TRACE_END(algebra, "sum_operation");
+}
+
+/// @brief Accumulates the element-wise sum of multiple scaled states into the output state.
+/// @param y The output state.
+/// @param op Operation to apply for element-wise computation (e.g., addition, subtraction).
+/// @param a First scalar value to scale the first state.
+/// @param x State corresponding to the first scalar.
+/// @param args Additional scalars and states.
+/// @note Small states with a size known at compile time (e.g., `std::array`)
+/// are processed by fully unrolled code, the others by the iterator version.
+template <
+    class State,
+    class Op,
+    class T,
+    class X,
+    class... Args,
+    std::enable_if_t<numint::detail::is_state_v<State>, int> = 0>
+constexpr void accumulate_operation(State &y, Op op, T a, const X &x, const Args &...args) noexcept
+{
+    NUMINT_TRACE_BEGIN(algebra);
+    if constexpr (detail::is_unrolled_v<State>) {
+        detail::unrolled_scaled_sum<true>(std::make_index_sequence<std::tuple_size_v<State>>(), y, op, a, x, args...);
+    } else {
+        accumulate_operation(
+            detail::state_begin(y), detail::state_end(y), op, a, detail::to_iterator_arg(x),
+            detail::to_iterator_arg(args)...);
     }
+    NUMINT_TRACE_END(algebra, "accumulate_operation");
 }
 
 } // namespace numint::detail::it_algebra
@@ -0,0 +1,72 @@
+/// @file landing_step.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The step shared by the drivers which land exactly on given times
+/// (`integrate_schedule`, `integrate_adaptive` with time stops, `steps`), so
+/// that they all take the same steps.
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+namespace numint::detail
+{
+
+/// @brief Takes one step towards a time, without going beyond it.
+///
+/// @details The step lands exactly on the time: it can be stretched by 1%,
+/// rather than leaving a sliver due to rounding in the accumulated time, and
+/// with adaptive steppers, when the remaining time is between one and two
+/// steps, it is split into two equal steps. A step shortened to land can only
+/// reduce the step size learned by an adaptive stepper.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+///
+/// @param stepper The stepper used to perform the integration, already sized.
+/// @param system The system being integrated.
+/// @param state The state of the system, which will be updated.
+/// @param time The current time, advanced by the step.
+/// @param time_delta The size of the next step, updated by adaptive steppers.
+/// @param stop The time to land on, which must follow the current time.
+///
+/// @return The size of the step taken.
+template <class Stepper, class System>
+constexpr auto landing_step(
+    Stepper &stepper,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type &time,
+    typename Stepper::time_type &time_delta,
+    typename Stepper::time_type stop) -> typename Stepper::time_type
+{
+    using time_type = typename Stepper::time_type;
+
+    const time_type remaining = stop - time;
+    // Land with a slightly longer step, rather than leaving a sliver due to
+    // rounding in the accumulated time.
+    const bool landing        = !((time_delta * 1.01) < remaining);
+    time_type step            = landing ? remaining : time_delta;
+    if constexpr (Stepper::is_adaptive_stepper) {
+        // Split what is left in two steps, rather than leaving a sliver.
+        if (!landing && (remaining < 2 * time_delta)) {
+            step = remaining / 2;
+        }
+    }
+    // Perform one integration step.
+    stepper.do_step(std::forward<System>(system), state, time, step);
+    // Advance time, landing exactly on the stop.
+    time = landing ? stop : (time + step);
+    // Update integration step size.
+    if constexpr (Stepper::is_adaptive_stepper) {
+        if (step < time_delta) {
+            // A shortened step can only reduce the step size.
+            time_delta *= std::min(time_type(1), stepper.get_time_delta() / step);
+        } else {
+            time_delta = stepper.get_time_delta();
+        }
+    }
+    return step;
+}
+
+} // namespace numint::detail
@@ -1,17 +1,27 @@
 /// @file observer.hpp
 /// @author Enrico Fraccaroli (enry.frak@gmail.com)
-/// @brief
+/// @brief Observers receive the state and the time after each integration
+/// step. The solver takes them as template arguments, so they are called
+/// directly, and can be inlined or removed by the compiler.
 
 #pragma once
 
+#include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <ratio>
 
 namespace numint::detail
 {
 
 /// @brief Observer class.
 ///
+/// @details The observation is not virtual: the solver is instantiated with
+/// the type of the derived observer, whose own `operator()` hides this one.
+/// Hence the base cannot observe on behalf of a derived observer, and its
+/// `operator()` is protected, so that calling it through a reference to the
+/// base (which would skip the derived one) does not compile.
+///
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
@@ -22,7 +32,7 @@ public:
     Observer() = default;
 
     /// @brief Destructor.
-    virtual ~Observer() = default;
+    ~Observer() = default;
 
     /// @brief Copy constructor.
     /// @param other The logger instance to copy from.
@@ -42,10 +52,26 @@ public:
     /// @return Reference to the logger instance.
     auto operator=(Observer &&other) noexcept -> Observer & = default;
 
-    /// @brief Perform the observation.
+protected:
+    /// @brief Perform the observation, which derived observers provide.
     /// @param x The state vector.
     /// @param t The time.
-    virtual void operator()(const State &x, const Time &t) { (void)x, (void)t; }
+    constexpr void operator()(const State &x, const Time &t) noexcept { (void)x, (void)t; }
+};
+
+/// @brief Observer that does nothing, for when only the final state is
+/// needed. Its call is empty, and compiles away.
+class ObserverNull
+{
+public:
+    /// @brief Ignores the observation.
+    /// @param x The state vector.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, const Time &t) const noexcept
+    {
+        (void)x, (void)t;
+    }
 };
 
 /// @brief Observer class that decimates the observation.
@@ -83,6 +109,62 @@ private:
     std::size_t decimation_cnt{};
 };
 
+/// @brief Observer class that samples the observation in time, rather than
+/// every few steps, so that the samples do not depend on the step size.
+///
+/// @details A state is observed when the time reaches the next sample, then
+/// the following sample is placed one period later, skipping the ones the step
+/// jumped over. The period can be fixed at compile time, as a ratio of seconds
+/// (e.g., `std::milli`), or at runtime through the constructor, which takes
+/// precedence. A zero period observes every state.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Period The compile-time sampling period.
+template <class State, class Time, class Period = std::ratio<0>>
+class ObserverSample : public Observer<State, Time>
+{
+protected:
+    /// @brief Constructor.
+    /// @param period The sampling period, defaults to the compile-time one.
+    explicit ObserverSample(Time period = Time(Period::num) / Time(Period::den))
+        : m_period(period)
+        , m_next()
+        , m_started(false)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Determines if the observer should observe the current state.
+    /// @param t The time of the state.
+    /// @return true if the time reached the next sample, false otherwise.
+    constexpr auto observe(const Time &t) -> bool
+    {
+        if (!(m_period > Time(0))) {
+            return true;
+        }
+        // The first observation starts the sampling.
+        if (!m_started) {
+            m_started = true;
+            m_next    = t + m_period;
+            return true;
+        }
+        if (t < m_next) {
+            return false;
+        }
+        m_next += m_period * (std::floor((t - m_next) / m_period) + Time(1));
+        return true;
+    }
+
+private:
+    /// @brief The sampling period.
+    Time m_period;
+    /// @brief The time of the next sample.
+    Time m_next;
+    /// @brief If the first observation took place.
+    bool m_started;
+};
+
 /// @brief Observer that prints the state vector.
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
@@ -91,7 +173,7 @@ template <class State, class Time, std::size_t DECIMATION = 0>
 class ObserverPrint : public ObserverDecimate<State, Time, DECIMATION>
 {
 public:
-    void operator()(const State &x, const Time &t) override
+    void operator()(const State &x, const Time &t)
     {
         if (this->observe()) {
             std::cout << t << " " << x << "\n";
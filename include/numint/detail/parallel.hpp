@@ -0,0 +1,318 @@
+/// @file parallel.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A persistent thread pool, used by the algebra to split operations on
+/// huge states into chunks, and an allocator which places the memory of a state
+/// close to the threads that process it.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+/// @brief The number of threads of the pool, zero uses all the hardware threads.
+#ifndef NUMINT_PARALLEL_THREADS
+#define NUMINT_PARALLEL_THREADS 0
+#endif
+
+/// @brief The number of elements below which operations are not split between
+/// threads, since the synchronization would cost more than the work.
+#ifndef NUMINT_PARALLEL_THRESHOLD
+#define NUMINT_PARALLEL_THRESHOLD 65536
+#endif
+
+namespace numint::detail
+{
+
+/// @brief A pool of threads which stay alive between calls. Each call runs the
+/// same function once per thread, and the i-th call always runs on the i-th
+/// thread, so that a chunk of a state is always processed by the same thread.
+class thread_pool
+{
+public:
+    /// @brief Starts the threads of the pool.
+    /// @param threads The number of threads, including the calling one.
+    explicit thread_pool(std::size_t threads)
+    {
+        threads = std::max<std::size_t>(threads, 1);
+        m_workers.reserve(threads - 1);
+        for (std::size_t index = 1; index < threads; ++index) {
+            m_workers.emplace_back(&thread_pool::worker, this, index);
+        }
+    }
+
+    /// @brief Stops and joins the threads of the pool.
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /// @brief Delete copy constructor.
+    thread_pool(const thread_pool &other) = delete;
+
+    /// @brief Delete copy assignment.
+    thread_pool &operator=(const thread_pool &other) = delete;
+
+    /// @brief Returns the number of threads, including the calling one.
+    /// @return the number of threads.
+    auto size() const noexcept -> std::size_t { return m_workers.size() + 1; }
+
+    /// @brief Calls `function(index)` for each index in `[0, size())`, and
+    /// waits for all the calls to complete. The calling thread takes index 0.
+    /// Calls made from within the pool run sequentially on the caller.
+    /// @param function The function to run.
+    template <class Function>
+    void run(const Function &function)
+    {
+        if (m_workers.empty() || inside_pool()) {
+            for (std::size_t index = 0; index < this->size(); ++index) {
+                function(index);
+            }
+            return;
+        }
+        // Only one run at a time, when called from several threads.
+        std::lock_guard<std::mutex> guard(m_run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_context = &function;
+            m_invoke  = [](const void *context, std::size_t index) {
+                (*static_cast<const Function *>(context))(index);
+            };
+            m_pending = m_workers.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+        inside_pool() = true;
+        function(0);
+        inside_pool() = false;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+    }
+
+    /// @brief Returns the pool shared by the whole program, which is started
+    /// on first use with `NUMINT_PARALLEL_THREADS` threads.
+    /// @return the shared pool.
+    static auto instance() -> thread_pool &
+    {
+        static thread_pool pool(
+            (NUMINT_PARALLEL_THREADS > 0) ? static_cast<std::size_t>(NUMINT_PARALLEL_THREADS)
+                                          : static_cast<std::size_t>(std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+private:
+    /// @brief Tells if the current thread is running a function of a pool.
+    /// @return a reference to the thread-local flag.
+    static auto inside_pool() noexcept -> bool &
+    {
+        thread_local bool value = false;
+        return value;
+    }
+
+    /// @brief The loop of each worker thread.
+    /// @param index The index the thread passes to the functions.
+    void worker(std::size_t index)
+    {
+        inside_pool() = true;
+        std::size_t generation = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [this, generation] { return m_stop || (m_generation != generation); });
+            if (m_stop) {
+                return;
+            }
+            generation          = m_generation;
+            const auto invoke   = m_invoke;
+            const void *context = m_context;
+            lock.unlock();
+            invoke(context, index);
+            lock.lock();
+            if (--m_pending == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    /// The worker threads.
+    std::vector<std::thread> m_workers;
+    /// Serializes the calls to run.
+    std::mutex m_run_mutex;
+    /// Protects the state shared with the workers.
+    std::mutex m_mutex;
+    /// Wakes up the workers when there is a new function to run.
+    std::condition_variable m_start;
+    /// Wakes up the caller when all the workers are done.
+    std::condition_variable m_done;
+    /// The function being run.
+    const void *m_context{};
+    /// Calls the function being run.
+    void (*m_invoke)(const void *, std::size_t){};
+    /// Incremented each time there is a new function to run.
+    std::size_t m_generation{};
+    /// The number of workers still running the function.
+    std::size_t m_pending{};
+    /// Tells the workers to stop.
+    bool m_stop{};
+};
+
+/// @brief Computes the range of elements of the given chunk. Chunks are
+/// multiples of a cache line, so that threads never write to the same line.
+/// @tparam T The type of the elements.
+/// @param n The total number of elements.
+/// @param index The index of the chunk.
+/// @param count The number of chunks.
+/// @return The first and one past the last element of the chunk.
+template <class T>
+constexpr auto chunk_range(std::size_t n, std::size_t index, std::size_t count) noexcept
+    -> std::pair<std::size_t, std::size_t>
+{
+    constexpr std::size_t granularity = std::max<std::size_t>(1, 64 / sizeof(T));
+    // Split evenly, and round up to the granularity.
+    std::size_t chunk = (n + count - 1) / count;
+    chunk             = ((chunk + granularity - 1) / granularity) * granularity;
+    // Clamp the range.
+    const std::size_t first = std::min(n, index * chunk);
+    return {first, std::min(n, first + chunk)};
+}
+
+/// @brief Splits the elements into one chunk per thread of the shared pool,
+/// and calls `function(first, last)` on each non-empty chunk.
+/// @tparam T The type of the elements.
+/// @param n The total number of elements.
+/// @param function The function to run on each chunk.
+template <class T, class Function>
+inline void parallel_chunks(std::size_t n, const Function &function)
+{
+    thread_pool &pool = thread_pool::instance();
+    pool.run([&pool, n, &function](std::size_t index) {
+        const auto range = chunk_range<T>(n, index, pool.size());
+        if (range.first < range.second) {
+            function(range.first, range.second);
+        }
+    });
+}
+
+/// @brief An allocator for huge states, which zero-fills the memory with the
+/// threads of the shared pool, using the same chunks as the algebra. Operating
+/// systems place a page on the memory node of the thread that touches it
+/// first, so each thread then works on memory close to it.
+/// @tparam T The type of the elements.
+/// @tparam HugePages If true, asks the kernel to back the memory with huge
+/// pages (Linux only, ignored elsewhere).
+template <class T, bool HugePages = false>
+class first_touch_allocator
+{
+public:
+    /// @brief The type of the elements.
+    using value_type = T;
+
+    /// @brief The same allocator, for elements of a different type.
+    /// @tparam U The other type.
+    template <class U>
+    struct rebind {
+        /// @brief The rebound allocator.
+        using other = first_touch_allocator<U, HugePages>;
+    };
+
+    /// @brief Default constructor.
+    constexpr first_touch_allocator() noexcept = default;
+
+    /// @brief Conversion from the allocator of a different type.
+    template <class U>
+    constexpr first_touch_allocator(const first_touch_allocator<U, HugePages> &) noexcept
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Allocates and first-touches the memory for the given elements.
+    /// @param n The number of elements.
+    /// @return A pointer to the memory.
+    auto allocate(std::size_t n) -> T *
+    {
+        if (n > static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max() - alignment) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        // The size must be a multiple of the alignment.
+        const std::size_t bytes = ((n * sizeof(T) + alignment - 1) / alignment) * alignment;
+#if defined(_MSC_VER)
+        void *memory = _aligned_malloc(bytes, alignment);
+#else
+        void *memory = std::aligned_alloc(alignment, bytes);
+#endif
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if constexpr (HugePages) {
+            // Only a hint, failures are not an error.
+            (void)madvise(memory, bytes, MADV_HUGEPAGE);
+        }
+#endif
+        // Touch the pages from the threads that will process them.
+        unsigned char *bytes_ptr = static_cast<unsigned char *>(memory);
+        if (n >= NUMINT_PARALLEL_THRESHOLD) {
+            parallel_chunks<T>(n, [bytes_ptr](std::size_t first, std::size_t last) {
+                std::memset(bytes_ptr + first * sizeof(T), 0, (last - first) * sizeof(T));
+            });
+        }
+        return static_cast<T *>(memory);
+    }
+
+    /// @brief Releases the memory.
+    /// @param pointer The pointer returned by allocate.
+    /// @param n The number of elements.
+    void deallocate(T *pointer, std::size_t n) noexcept
+    {
+        (void)n;
+#if defined(_MSC_VER)
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+
+    /// @brief All the instances are interchangeable.
+    /// @return true.
+    template <class U>
+    constexpr auto operator==(const first_touch_allocator<U, HugePages> &) const noexcept -> bool
+    {
+        return true;
+    }
+
+    /// @brief All the instances are interchangeable.
+    /// @return false.
+    template <class U>
+    constexpr auto operator!=(const first_touch_allocator<U, HugePages> &) const noexcept -> bool
+    {
+        return false;
+    }
+
+private:
+    /// The alignment of the memory: a huge page, or a regular page.
+    static constexpr std::size_t alignment = HugePages ? (std::size_t(2) << 20U) : std::size_t(4096);
+};
+
+} // namespace numint::detail
@@ -0,0 +1,287 @@
+/// @file profiler.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A profiler of the evaluations of the system: it wraps the system,
+/// counts the calls, measures how long each one takes, attributes it to the
+/// stage of the stepper which made it, and reports which fraction of the wall
+/// time goes into the system rather than into the library.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ios>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace numint::detail
+{
+
+/// @brief Wraps a system, and profiles its evaluations.
+///
+/// @details The steppers tell the system which of their stages evaluates it
+/// (e.g., "rk4.k3"), and `stepper_adaptive` tells it which of its steppers does
+/// (i.e., "main" or "tuner"), through `set_stage` and `set_role`. Each call is
+/// timed with `std::chrono::steady_clock`, minus the cost of reading the clock,
+/// and the wall time spans from the beginning of the first call to the end of
+/// the last one, hence the time outside the system is the one spent by the
+/// library and the observers. A profiler is not meant to be shared between
+/// threads, use one per thread.
+///
+/// @tparam System The type of the profiled system.
+template <class System>
+class profiled_system
+{
+public:
+    /// @brief The number of bins of the histogram of the latency, the i-th one
+    /// holding the calls which took [2^i, 2^(i + 1)) nanoseconds.
+    static constexpr std::size_t histogram_bins = 40;
+
+    /// @brief The evaluations made by one stage of a stepper.
+    struct stage_entry {
+        /// The stepper which made the calls (e.g., "main"), nullptr if not known.
+        const char *role;
+        /// The stage which made the calls (e.g., "rk4.k1"), nullptr outside a stepper.
+        const char *stage;
+        /// The number of calls.
+        std::uint64_t calls;
+        /// The time spent in the system, in nanoseconds.
+        std::uint64_t nanoseconds;
+    };
+
+    /// @brief Wraps the system, which must outlive the profiler.
+    /// @param system The system.
+    explicit profiled_system(System &system)
+        : m_system(system)
+        , m_role(nullptr)
+        , m_stage(nullptr)
+        , m_last(0)
+        , m_clock_cost(profiled_system::measure_clock_cost())
+    {
+        this->reset();
+    }
+
+    /// @brief Evaluates the system, and records the call.
+    /// @param x The state.
+    /// @param dxdt The derivative, computed by the system.
+    /// @param t The time.
+    template <class State, class Derivative, class Time>
+    void operator()(const State &x, Derivative &dxdt, Time t)
+    {
+        const auto begin = clock_type::now();
+        m_system(x, dxdt, t);
+        const auto end = clock_type::now();
+        this->record(begin, end);
+        // Calls made outside a stepper are not attributed to the last stage.
+        m_stage = nullptr;
+    }
+
+    /// @brief Sets the stage of the stepper making the next call.
+    /// @param stage The stage, a literal.
+    void set_stage(const char *stage) noexcept { m_stage = stage; }
+
+    /// @brief Sets the stepper making the next calls, within a composite one.
+    /// @param role The stepper, a literal, or nullptr.
+    void set_role(const char *role) noexcept { m_role = role; }
+
+    /// @brief Returns the number of calls.
+    /// @return The number of calls.
+    auto calls() const noexcept -> std::uint64_t { return m_calls; }
+
+    /// @brief Returns the time spent in the system.
+    /// @return The time, in nanoseconds.
+    auto rhs_time() const noexcept -> std::uint64_t { return m_rhs_time; }
+
+    /// @brief Returns the time from the beginning of the first call to the end of the last one.
+    /// @return The time, in nanoseconds.
+    auto wall_time() const noexcept -> std::uint64_t
+    {
+        return (m_calls > 0) ? nanoseconds_between(m_first, m_end) : 0;
+    }
+
+    /// @brief Returns the fraction of the wall time spent in the system.
+    /// @return The fraction, in [0, 1].
+    auto rhs_fraction() const noexcept -> double
+    {
+        const std::uint64_t wall = this->wall_time();
+        return (wall > 0) ? std::min(static_cast<double>(m_rhs_time) / static_cast<double>(wall), 1.) : 0.;
+    }
+
+    /// @brief Returns the fastest call.
+    /// @return The latency, in nanoseconds.
+    auto min_latency() const noexcept -> std::uint64_t { return (m_calls > 0) ? m_min_latency : 0; }
+
+    /// @brief Returns the slowest call.
+    /// @return The latency, in nanoseconds.
+    auto max_latency() const noexcept -> std::uint64_t { return m_max_latency; }
+
+    /// @brief Returns the mean latency of a call.
+    /// @return The latency, in nanoseconds.
+    auto mean_latency() const noexcept -> double
+    {
+        return (m_calls > 0) ? (static_cast<double>(m_rhs_time) / static_cast<double>(m_calls)) : 0.;
+    }
+
+    /// @brief Returns the cost of reading the clock, subtracted from each latency.
+    /// @return The cost, in nanoseconds.
+    auto clock_cost() const noexcept -> std::uint64_t { return m_clock_cost; }
+
+    /// @brief Returns the histogram of the latency.
+    /// @return The number of calls in each bin.
+    auto histogram() const noexcept -> const std::array<std::uint64_t, histogram_bins> & { return m_histogram; }
+
+    /// @brief Returns the calls made by each stage, in order of appearance.
+    /// @return The stages.
+    auto stages() const noexcept -> const std::vector<stage_entry> & { return m_stages; }
+
+    /// @brief Forgets the calls recorded so far.
+    void reset()
+    {
+        m_calls       = 0;
+        m_rhs_time    = 0;
+        m_min_latency = std::numeric_limits<std::uint64_t>::max();
+        m_max_latency = 0;
+        m_histogram.fill(0);
+        m_stages.clear();
+        m_last = 0;
+    }
+
+    /// @brief Writes a report of the calls: the share of the wall time spent in
+    /// the system, the calls of each stage, and the histogram of the latency.
+    /// @param out The output stream.
+    void report(std::ostream &out) const
+    {
+        const std::ios_base::fmtflags flags = out.flags();
+        const std::streamsize precision     = out.precision();
+        const double rhs                    = static_cast<double>(m_rhs_time) * 1e-09;
+        const double wall                   = static_cast<double>(this->wall_time()) * 1e-09;
+        const double share                  = this->rhs_fraction() * 100.;
+        out << m_calls << " calls to the system, " << rhs << " s of " << wall << " s of wall time ("
+            << std::fixed << std::setprecision(1) << share << "% system, " << (100. - share)
+            << "% library and observers)\n";
+        out << "latency [ns]: min " << this->min_latency() << ", mean " << this->mean_latency() << ", max "
+            << m_max_latency << ", clock cost " << m_clock_cost << "\n";
+        out << std::setw(8) << "role" << std::setw(20) << "stage" << std::setw(12) << "calls" << std::setw(14)
+            << "mean [ns]" << std::setw(10) << "share" << "\n";
+        for (const auto &entry : m_stages) {
+            const double mean = static_cast<double>(entry.nanoseconds) / static_cast<double>(entry.calls);
+            const double part =
+                (m_rhs_time > 0) ? (static_cast<double>(entry.nanoseconds) * 100. / static_cast<double>(m_rhs_time))
+                                 : 0.;
+            out << std::setw(8) << ((entry.role != nullptr) ? entry.role : "-") << std::setw(20)
+                << ((entry.stage != nullptr) ? entry.stage : "-") << std::setw(12) << entry.calls << std::setw(14)
+                << mean << std::setw(9) << part << "%\n";
+        }
+        out << "latency histogram [ns]:\n";
+        for (std::size_t i = 0; i < histogram_bins; ++i) {
+            if (m_histogram[i] > 0) {
+                out << "    [" << (std::uint64_t(1) << i) << ", " << (std::uint64_t(1) << (i + 1)) << "): "
+                    << m_histogram[i] << "\n";
+            }
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    /// The clock used to time the calls.
+    using clock_type = std::chrono::steady_clock;
+
+    /// @brief Returns the nanoseconds between two instants.
+    /// @param begin The first instant.
+    /// @param end The second instant.
+    /// @return The nanoseconds.
+    static auto nanoseconds_between(clock_type::time_point begin, clock_type::time_point end) noexcept
+        -> std::uint64_t
+    {
+        const auto count = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        return (count > 0) ? static_cast<std::uint64_t>(count) : 0;
+    }
+
+    /// @brief Measures the cost of reading the clock twice in a row.
+    /// @return The smallest cost observed, in nanoseconds.
+    static auto measure_clock_cost() noexcept -> std::uint64_t
+    {
+        std::uint64_t cost = std::numeric_limits<std::uint64_t>::max();
+        for (unsigned i = 0; i < 1000; ++i) {
+            const auto begin = clock_type::now();
+            cost             = std::min(cost, nanoseconds_between(begin, clock_type::now()));
+        }
+        return cost;
+    }
+
+    /// @brief Records a call.
+    /// @param begin When the call began.
+    /// @param end When the call ended.
+    void record(clock_type::time_point begin, clock_type::time_point end)
+    {
+        const std::uint64_t elapsed = nanoseconds_between(begin, end);
+        const std::uint64_t latency = (elapsed > m_clock_cost) ? (elapsed - m_clock_cost) : 0;
+        if (m_calls == 0) {
+            m_first = begin;
+        }
+        m_end = end;
+        ++m_calls;
+        m_rhs_time += latency;
+        m_min_latency = std::min(m_min_latency, latency);
+        m_max_latency = std::max(m_max_latency, latency);
+        std::size_t bin = 0;
+        for (std::uint64_t value = latency; (value > 1) && (bin < (histogram_bins - 1)); value >>= 1U) {
+            ++bin;
+        }
+        ++m_histogram[bin];
+        // The labels are literals, hence they are compared by address, and
+        // consecutive steps go through the same stages.
+        if ((m_last >= m_stages.size()) || (m_stages[m_last].role != m_role) || (m_stages[m_last].stage != m_stage)) {
+            m_last = m_stages.size();
+            for (std::size_t i = 0; i < m_stages.size(); ++i) {
+                if ((m_stages[i].role == m_role) && (m_stages[i].stage == m_stage)) {
+                    m_last = i;
+                    break;
+                }
+            }
+            if (m_last == m_stages.size()) {
+                m_stages.push_back(stage_entry{m_role, m_stage, 0, 0});
+            }
+        }
+        ++m_stages[m_last].calls;
+        m_stages[m_last].nanoseconds += latency;
+        // Look for the next stage first, next time.
+        if ((m_last + 1) < m_stages.size()) {
+            ++m_last;
+        }
+    }
+
+    /// The profiled system.
+    System &m_system;
+    /// The stepper making the calls, within a composite one.
+    const char *m_role;
+    /// The stage of the stepper making the next call.
+    const char *m_stage;
+    /// The calls made by each stage.
+    std::vector<stage_entry> m_stages;
+    /// The stage to look at first, for the next call.
+    std::size_t m_last;
+    /// The cost of reading the clock twice, in nanoseconds.
+    std::uint64_t m_clock_cost;
+    /// The number of calls.
+    std::uint64_t m_calls{};
+    /// The time spent in the system, in nanoseconds.
+    std::uint64_t m_rhs_time{};
+    /// The fastest call, in nanoseconds.
+    std::uint64_t m_min_latency{};
+    /// The slowest call, in nanoseconds.
+    std::uint64_t m_max_latency{};
+    /// The histogram of the latency.
+    std::array<std::uint64_t, histogram_bins> m_histogram{};
+    /// When the first call began.
+    clock_type::time_point m_first{};
+    /// When the last call ended.
+    clock_type::time_point m_end{};
+};
+
+} // namespace numint::detail
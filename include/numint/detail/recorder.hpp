@@ -0,0 +1,247 @@
+/// @file recorder.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An observer that records the trajectory in fixed-size blocks of
+/// columns, which are kept in memory or handed to a sink when full.
+
+#pragma once
+
+#include "numint/detail/observer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numint::detail
+{
+
+/// @brief A block of recorded rows, stored by columns: the times, and one
+/// column for each element of the state.
+/// @tparam Value The type of the elements of the state.
+/// @tparam Time The datatype used to hold time.
+template <class Value, class Time>
+class record_block
+{
+public:
+    /// @brief Creates a new empty block.
+    /// @param capacity The number of rows of the block.
+    /// @param columns The number of elements of the state.
+    record_block(std::size_t capacity, std::size_t columns)
+        : m_time(capacity)
+        , m_values(capacity * columns)
+        , m_capacity(capacity)
+        , m_columns(columns)
+        , m_rows(0)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of rows recorded in the block.
+    /// @return The number of rows.
+    auto size() const -> std::size_t { return m_rows; }
+
+    /// @brief Returns the number of columns, the time excluded.
+    /// @return The number of columns.
+    auto columns() const -> std::size_t { return m_columns; }
+
+    /// @brief Checks if the block is full.
+    /// @return true if no more rows fit in the block.
+    auto full() const -> bool { return m_rows == m_capacity; }
+
+    /// @brief Returns the recorded times.
+    /// @return Pointer to the first of `size()` times.
+    auto time() const -> const Time * { return m_time.data(); }
+
+    /// @brief Returns a recorded column.
+    /// @param index The index of the element of the state.
+    /// @return Pointer to the first of `size()` values.
+    auto column(std::size_t index) const -> const Value * { return m_values.data() + (index * m_capacity); }
+
+    /// @brief Appends a row to the block, which must not be full.
+    /// @param x The state vector.
+    /// @param t The time.
+    template <class State>
+    void append(const State &x, const Time &t)
+    {
+        m_time[m_rows] = t;
+        for (std::size_t i = 0; i < m_columns; ++i) {
+            m_values[(i * m_capacity) + m_rows] = x[i];
+        }
+        ++m_rows;
+    }
+
+    /// @brief Empties the block, keeping its memory.
+    void clear() { m_rows = 0; }
+
+private:
+    /// The recorded times.
+    std::vector<Time> m_time;
+    /// The recorded values, one column after the other.
+    std::vector<Value> m_values;
+    /// The number of rows of the block.
+    std::size_t m_capacity;
+    /// The number of columns, the time excluded.
+    std::size_t m_columns;
+    /// The number of rows recorded.
+    std::size_t m_rows;
+};
+
+/// @brief Observer that records the trajectory.
+///
+/// @details The rows are written in fixed-size blocks of columns, rather than
+/// appended to a growing vector per variable, so that recording a row costs the
+/// same however long the trajectory is. The blocks are taken from a pool,
+/// presized on the first observation from the expected number of samples
+/// (e.g., from `compute_samples`). A full block is either kept in memory, or,
+/// when a sink is given, handed to the sink and returned to the pool, so that
+/// the memory used does not grow with the trajectory.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam BlockSize The number of rows of a block.
+template <class State, class Time, std::size_t BlockSize = 1024>
+class ObserverRecord : public Observer<State, Time>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+    /// @brief The type of the blocks.
+    using block_type = record_block<value_type, Time>;
+    /// @brief The type of the sink receiving the full blocks.
+    using sink_type  = std::function<void(const block_type &)>;
+
+    /// @brief Creates a new recorder.
+    /// @param samples The expected number of samples, used to presize the pool.
+    /// @param sink The function receiving the full blocks, if empty they are
+    /// kept in memory.
+    explicit ObserverRecord(std::size_t samples = 0, sink_type sink = sink_type())
+        : m_samples(samples)
+        , m_sink(std::move(sink))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Records a row.
+    /// @param x The state vector.
+    /// @param t The time.
+    void operator()(const State &x, const Time &t)
+    {
+        if (!m_current) {
+            m_current = this->acquire(x.size());
+        }
+        m_current->append(x, t);
+        if (m_current->full()) {
+            this->release();
+        }
+    }
+
+    /// @brief Hands the partially filled block to the sink, to call when the
+    /// integration is over. Without a sink, the block is kept in memory.
+    void flush()
+    {
+        if (m_current && (m_current->size() > 0)) {
+            this->release();
+        }
+    }
+
+    /// @brief Returns the number of rows in memory.
+    /// @return The number of rows.
+    auto size() const -> std::size_t
+    {
+        std::size_t rows = m_current ? m_current->size() : 0;
+        for (const auto &block : m_blocks) {
+            rows += block->size();
+        }
+        return rows;
+    }
+
+    /// @brief Returns the blocks kept in memory, the current one excluded.
+    /// @return The blocks.
+    auto blocks() const -> const std::vector<std::unique_ptr<block_type>> & { return m_blocks; }
+
+    /// @brief Gathers the times of the rows in memory.
+    /// @return The times.
+    auto time() const -> std::vector<Time>
+    {
+        return this->gather([](const block_type &block) { return block.time(); });
+    }
+
+    /// @brief Gathers a column of the rows in memory.
+    /// @param index The index of the element of the state.
+    /// @return The values.
+    auto column(std::size_t index) const -> std::vector<value_type>
+    {
+        return this->gather([index](const block_type &block) { return block.column(index); });
+    }
+
+private:
+    /// @brief Takes an empty block from the pool, which is filled on the first call.
+    /// @param columns The number of elements of the state.
+    /// @return The block.
+    auto acquire(std::size_t columns) -> std::unique_ptr<block_type>
+    {
+        if (m_pool.empty() && !m_current && m_blocks.empty()) {
+            // Without a sink, the blocks are kept, so we need enough for all the samples.
+            const std::size_t count = m_sink ? 1 : ((m_samples + BlockSize - 1) / BlockSize);
+            m_pool.reserve(count);
+            m_blocks.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                m_pool.emplace_back(std::make_unique<block_type>(BlockSize, columns));
+            }
+        }
+        if (m_pool.empty()) {
+            return std::make_unique<block_type>(BlockSize, columns);
+        }
+        auto block = std::move(m_pool.back());
+        m_pool.pop_back();
+        return block;
+    }
+
+    /// @brief Hands the current block to the sink, or keeps it in memory.
+    void release()
+    {
+        if (m_sink) {
+            m_sink(*m_current);
+            m_current->clear();
+        } else {
+            m_blocks.emplace_back(std::move(m_current));
+        }
+    }
+
+    /// @brief Gathers one column from the blocks in memory.
+    /// @param select Returns the column of a block.
+    /// @return The values.
+    template <class Select>
+    auto gather(Select select) const
+    {
+        using column_type = std::remove_const_t<std::remove_pointer_t<decltype(select(std::declval<block_type>()))>>;
+        std::vector<column_type> values;
+        values.reserve(this->size());
+        const auto append = [&](const block_type &block) {
+            const column_type *data = select(block);
+            values.insert(values.end(), data, data + block.size());
+        };
+        for (const auto &block : m_blocks) {
+            append(*block);
+        }
+        if (m_current) {
+            append(*m_current);
+        }
+        return values;
+    }
+
+    /// The expected number of samples.
+    std::size_t m_samples;
+    /// The function receiving the full blocks.
+    sink_type m_sink;
+    /// The block being filled.
+    std::unique_ptr<block_type> m_current;
+    /// The blocks kept in memory.
+    std::vector<std::unique_ptr<block_type>> m_blocks;
+    /// The empty blocks.
+    std::vector<std::unique_ptr<block_type>> m_pool;
+};
+
+} // namespace numint::detail
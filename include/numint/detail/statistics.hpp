@@ -0,0 +1,108 @@
+/// @file statistics.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Statistics of an integration: evaluations of the system, steps, and
+/// the distribution of the step size. They are collected by the steppers only
+/// when `NUMINT_STATISTICS` is defined, otherwise they cost nothing.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace numint::detail
+{
+
+/// @brief Statistics of an integration, see `stats()` on the steppers.
+struct Statistics {
+    /// The number of bins of the histogram of the step size.
+    static constexpr std::size_t histogram_bins = 64;
+    /// The base-2 exponent of the lower edge of the first bin, the smaller
+    /// steps fall in the first bin.
+    static constexpr int histogram_min_exponent = -48;
+
+    /// The number of evaluations of the system (right-hand side).
+    std::uint64_t rhs_evaluations{};
+    /// The number of evaluations of the Jacobian, by implicit steppers.
+    std::uint64_t jacobian_evaluations{};
+    /// The number of LU factorizations, by implicit steppers.
+    std::uint64_t lu_factorizations{};
+    /// The number of accepted steps.
+    std::uint64_t accepted_steps{};
+    /// The number of rejected steps, which are taken again with a smaller size.
+    std::uint64_t rejected_steps{};
+    /// The smallest accepted step.
+    double min_delta{std::numeric_limits<double>::infinity()};
+    /// The largest accepted step.
+    double max_delta{};
+    /// The sum of the accepted steps.
+    double sum_delta{};
+    /// The number of accepted steps in each bin, the i-th bin holding the steps
+    /// in [2^(histogram_min_exponent + i), 2^(histogram_min_exponent + i + 1)).
+    std::array<std::uint64_t, histogram_bins> histogram{};
+
+    /// @brief Returns the mean accepted step.
+    /// @return The mean step, 0 without steps.
+    auto mean_delta() const noexcept -> double
+    {
+        return (accepted_steps > 0) ? (sum_delta / static_cast<double>(accepted_steps)) : 0.;
+    }
+
+    /// @brief Returns the bin of the histogram of a step size.
+    /// @param delta The step size.
+    /// @return The index of the bin.
+    static auto bin(double delta) noexcept -> std::size_t
+    {
+        int exponent = 0;
+        // frexp returns a mantissa in [0.5, 1), hence delta is in [2^(e-1), 2^e).
+        std::frexp(std::abs(delta), &exponent);
+        const int index = (exponent - 1) - histogram_min_exponent;
+        if (index < 0) {
+            return 0;
+        }
+        return std::min(static_cast<std::size_t>(index), histogram_bins - 1);
+    }
+
+    /// @brief Returns the lower edge of a bin of the histogram.
+    /// @param index The index of the bin.
+    /// @return The smallest step size of the bin.
+    static auto bin_lower_edge(std::size_t index) noexcept -> double
+    {
+        return std::ldexp(1., histogram_min_exponent + static_cast<int>(index));
+    }
+
+    /// @brief Records an accepted step.
+    /// @param delta The size of the step.
+    /// @param evaluations The evaluations of the system it took.
+    void accept(double delta, std::uint64_t evaluations) noexcept
+    {
+        rhs_evaluations += evaluations;
+        ++accepted_steps;
+        min_delta = std::min(min_delta, delta);
+        max_delta = std::max(max_delta, delta);
+        sum_delta += delta;
+        ++histogram[bin(delta)];
+    }
+
+    /// @brief Adds the statistics of another integration (e.g., of another thread).
+    /// @param other The other statistics.
+    void merge(const Statistics &other) noexcept
+    {
+        rhs_evaluations += other.rhs_evaluations;
+        jacobian_evaluations += other.jacobian_evaluations;
+        lu_factorizations += other.lu_factorizations;
+        accepted_steps += other.accepted_steps;
+        rejected_steps += other.rejected_steps;
+        min_delta = std::min(min_delta, other.min_delta);
+        max_delta = std::max(max_delta, other.max_delta);
+        sum_delta += other.sum_delta;
+        for (std::size_t i = 0; i < histogram_bins; ++i) {
+            histogram[i] += other.histogram[i];
+        }
+    }
+};
+
+} // namespace numint::detail
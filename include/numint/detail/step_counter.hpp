@@ -0,0 +1,84 @@
+/// @file step_counter.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The counters shared by the fixed-step steppers: the number of steps,
+/// and the statistics, which are collected only when `NUMINT_STATISTICS` is
+/// defined, together with their checkpoint.
+
+#pragma once
+
+#include "numint/detail/checkpoint.hpp"
+#include "numint/detail/statistics.hpp"
+
+#include <cstdint>
+
+namespace numint::detail
+{
+
+/// @brief Base of the fixed-step steppers, which counts their steps, and
+/// saves and restores the count in a checkpoint. A stepper records each of its
+/// steps through `count_step`.
+class step_counter
+{
+public:
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves the state of the stepper into a checkpoint, the internal
+    /// buffers excluded, as they are overwritten at each step.
+    /// @param writer The checkpoint being written.
+    void save(checkpoint_writer &writer) const
+    {
+        writer.write(m_steps);
+#ifdef NUMINT_STATISTICS
+        writer.write(m_stats);
+#endif
+    }
+
+    /// @brief Restores the state of the stepper from a checkpoint.
+    /// @param reader The checkpoint being read.
+    void load(checkpoint_reader &reader)
+    {
+        reader.read(m_steps);
+#ifdef NUMINT_STATISTICS
+        reader.read(m_stats);
+#endif
+    }
+
+    /// @brief Returns the statistics of the integration, which are collected
+    /// only when `NUMINT_STATISTICS` is defined.
+    /// @return The statistics.
+    auto stats() const -> Statistics
+    {
+#ifdef NUMINT_STATISTICS
+        return m_stats;
+#else
+        return Statistics();
+#endif
+    }
+
+protected:
+    /// @brief Counts a step.
+    /// @param dt The size of the step.
+    /// @param evaluations The evaluations of the system it took.
+    template <class Time>
+    constexpr void count_step(const Time &dt, std::uint64_t evaluations) noexcept
+    {
+        ++m_steps;
+#ifdef NUMINT_STATISTICS
+        m_stats.accept(static_cast<double>(dt), evaluations);
+#else
+        (void)dt, (void)evaluations;
+#endif
+    }
+
+private:
+    /// The number of steps taken during integration.
+    unsigned long m_steps{};
+#ifdef NUMINT_STATISTICS
+    /// The statistics of the integration.
+    Statistics m_stats;
+#endif
+};
+
+} // namespace numint::detail
@@ -0,0 +1,259 @@
+/// @file text_writer.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief An observer writing the trajectory as delimited text (e.g., CSV or
+/// TSV), formatting the values with `std::to_chars` into a large buffer which
+/// is written in big chunks, instead of going through `std::ostream`.
+
+#pragma once
+
+#include "numint/detail/observer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define NUMINT_TEXT_WRITER_POSIX
+#endif
+
+namespace numint::detail
+{
+
+/// @brief Observer that writes the trajectory as delimited text, one row per
+/// observation, the time first, after a line with the names of the columns.
+///
+/// @details Values are formatted with `std::to_chars`, which is locale
+/// independent, either with the shortest representation that reads back to the
+/// same value, or with a fixed precision. The text is gathered in a buffer,
+/// written with a single system call when it fills up.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class ObserverText : public Observer<State, Time>
+{
+public:
+    /// @brief Opens the output.
+    /// @param path The path of the file, the standard output if empty.
+    /// @param names The names of the columns, if empty they are named after
+    /// their index.
+    /// @param separator The character between the values (e.g., ',' or '\\t').
+    /// @param precision The number of digits, a negative one for the shortest
+    /// representation that reads back to the same value.
+    /// @param format The format of the values.
+    /// @param buffer_size The size of the buffer, in bytes.
+    explicit ObserverText(
+        const std::string &path        = std::string(),
+        std::vector<std::string> names = std::vector<std::string>(),
+        char separator                 = ',',
+        int precision                  = -1,
+        std::chars_format format       = std::chars_format::general,
+        std::size_t buffer_size        = std::size_t(1) << 20U)
+        : m_names(std::move(names))
+        , m_separator(separator)
+        , m_precision(precision)
+        , m_format(format)
+        , m_buffer(std::max<std::size_t>(buffer_size, 4096))
+        , m_used(0)
+        , m_started(false)
+    {
+        this->open(path);
+    }
+
+    /// @brief Writes the text left, and closes the output.
+    ~ObserverText()
+    {
+        try {
+            this->close();
+        } catch (...) {
+            // A destructor must not throw, call `close()` to see the errors.
+        }
+    }
+
+    /// @brief Copy constructor, deleted as the observer owns the output.
+    ObserverText(const ObserverText &other) = delete;
+
+    /// @brief Move constructor, deleted as the observer owns the output.
+    ObserverText(ObserverText &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the observer owns the output.
+    /// @return Reference to the observer.
+    auto operator=(const ObserverText &other) -> ObserverText & = delete;
+
+    /// @brief Move assignment operator, deleted as the observer owns the output.
+    /// @return Reference to the observer.
+    auto operator=(ObserverText &&other) -> ObserverText & = delete;
+
+    /// @brief Writes a row.
+    /// @param x The state vector.
+    /// @param t The time.
+    void operator()(const State &x, const Time &t)
+    {
+        if (!m_started) {
+            this->write_names(x.size());
+        }
+        this->append(t);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            this->append(m_separator);
+            this->append(x[i]);
+        }
+        this->append('\n');
+    }
+
+    /// @brief Writes the text gathered so far.
+    void flush()
+    {
+        std::size_t written = 0;
+        while (written < m_used) {
+#ifdef NUMINT_TEXT_WRITER_POSIX
+            const auto count = ::write(m_descriptor, m_buffer.data() + written, m_used - written);
+            if (count < 0) {
+                // A signal interrupted the call before it wrote anything.
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Cannot write the text output.");
+            }
+            written += static_cast<std::size_t>(count);
+#else
+            const std::size_t count = std::fwrite(m_buffer.data() + written, 1, m_used - written, m_file);
+            if (count == 0) {
+                throw std::runtime_error("Cannot write the text output.");
+            }
+            written += count;
+#endif
+        }
+        m_used = 0;
+    }
+
+    /// @brief Writes the text left, and closes the output.
+    void close()
+    {
+        this->flush();
+#ifdef NUMINT_TEXT_WRITER_POSIX
+        if (m_descriptor > STDERR_FILENO) {
+            ::close(m_descriptor);
+        }
+        m_descriptor = -1;
+#else
+        if ((m_file != nullptr) && (m_file != stdout)) {
+            std::fclose(m_file);
+        } else if (m_file != nullptr) {
+            std::fflush(m_file);
+        }
+        m_file = nullptr;
+#endif
+    }
+
+private:
+    /// @brief Opens the output.
+    /// @param path The path of the file, the standard output if empty.
+    void open(const std::string &path)
+    {
+#ifdef NUMINT_TEXT_WRITER_POSIX
+        m_descriptor = path.empty() ? STDOUT_FILENO : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (m_descriptor < 0) {
+            throw std::runtime_error("Cannot create the text file `" + path + "`.");
+        }
+#else
+        m_file = path.empty() ? stdout : std::fopen(path.c_str(), "wb");
+        if (m_file == nullptr) {
+            throw std::runtime_error("Cannot create the text file `" + path + "`.");
+        }
+#endif
+    }
+
+    /// @brief Writes the line with the names of the columns.
+    /// @param columns The dimension of the state.
+    void write_names(std::size_t columns)
+    {
+        if (m_names.empty()) {
+            for (std::size_t i = 0; i < columns; ++i) {
+                m_names.emplace_back("x" + std::to_string(i));
+            }
+        }
+        if (m_names.size() != columns) {
+            throw std::runtime_error("The number of names does not match the dimension of the state.");
+        }
+        this->append(std::string("time"));
+        for (const auto &name : m_names) {
+            this->append(m_separator);
+            this->append(name);
+        }
+        this->append('\n');
+        m_started = true;
+    }
+
+    /// @brief Appends a character.
+    /// @param character The character.
+    void append(char character)
+    {
+        if (m_used == m_buffer.size()) {
+            this->flush();
+        }
+        m_buffer[m_used++] = character;
+    }
+
+    /// @brief Appends a string.
+    /// @param text The string.
+    void append(const std::string &text)
+    {
+        for (const char character : text) {
+            this->append(character);
+        }
+    }
+
+    /// @brief Appends a formatted value.
+    /// @param value The value.
+    template <class T>
+    void append(const T &value)
+    {
+        for (unsigned attempt = 0; attempt < 2; ++attempt) {
+            char *first = m_buffer.data() + m_used;
+            char *last  = m_buffer.data() + m_buffer.size();
+            const auto result =
+                (m_precision < 0) ? std::to_chars(first, last, value, m_format)
+                                  : std::to_chars(first, last, value, m_format, m_precision);
+            if (result.ec == std::errc()) {
+                m_used = static_cast<std::size_t>(result.ptr - m_buffer.data());
+                return;
+            }
+            // Retry with the whole buffer.
+            this->flush();
+        }
+        throw std::runtime_error("The value does not fit in the text buffer.");
+    }
+
+#ifdef NUMINT_TEXT_WRITER_POSIX
+    /// The file descriptor of the output.
+    int m_descriptor{-1};
+#else
+    /// The output.
+    std::FILE *m_file{nullptr};
+#endif
+    /// The names of the columns.
+    std::vector<std::string> m_names;
+    /// The character between the values.
+    char m_separator;
+    /// The number of digits, negative for the shortest representation.
+    int m_precision;
+    /// The format of the values.
+    std::chars_format m_format;
+    /// The text not written yet.
+    std::vector<char> m_buffer;
+    /// The number of characters in the buffer.
+    std::size_t m_used;
+    /// If the names of the columns were written.
+    bool m_started;
+};
+
+} // namespace numint::detail
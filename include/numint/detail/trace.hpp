@@ -0,0 +1,331 @@
+/// @file trace.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A timeline of the integration (steps, evaluations of the system,
+/// algebra, observers), recorded in per-thread buffers, and exported in the
+/// Chrome trace format, which chrome://tracing and Perfetto display. The
+/// library records the timeline only when `NUMINT_TRACE` is defined.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef NUMINT_TRACE
+/// @brief Starts timing a span of the timeline, closed by `NUMINT_TRACE_END` with the same id.
+#define NUMINT_TRACE_BEGIN(id) const std::uint64_t numint_trace_##id = ::numint::detail::trace_now()
+/// @brief Records the span started by `NUMINT_TRACE_BEGIN` with the same id, under the given name.
+#define NUMINT_TRACE_END(id, name) ::numint::detail::trace_complete(name, numint_trace_##id)
+/// @brief Records an instant event of the timeline, with a value.
+#define NUMINT_TRACE_INSTANT(name, value) ::numint::detail::trace_instant(name, static_cast<double>(value))
+#else
+#define NUMINT_TRACE_BEGIN(id) static_cast<void>(0)
+#define NUMINT_TRACE_END(id, name) static_cast<void>(0)
+#define NUMINT_TRACE_INSTANT(name, value) static_cast<void>(0)
+#endif
+
+namespace numint::detail
+{
+
+/// @brief An event of the timeline.
+struct TraceEvent {
+    /// The name of the event, which must outlive the trace (e.g., a literal).
+    const char *name;
+    /// When the event began, in nanoseconds from the creation of the trace.
+    std::uint64_t begin;
+    /// How long the event lasted, in nanoseconds.
+    std::uint64_t duration;
+    /// The value of an instant event.
+    double value;
+    /// If the event is an instant, rather than a span.
+    bool instant;
+};
+
+/// @brief The events recorded by one thread. Only the owning thread appends,
+/// without locks, into storage allocated once, when the thread registers: when
+/// it is full, the new events are dropped, and counted, so that recording an
+/// event never allocates, nor moves the ones already recorded.
+class trace_buffer
+{
+public:
+    /// @brief Creates an empty buffer.
+    /// @param thread The index of the owning thread in the trace.
+    /// @param capacity The maximum number of events.
+    trace_buffer(std::uint32_t thread, std::size_t capacity)
+        : m_events(std::make_unique<TraceEvent[]>(capacity))
+        , m_capacity(capacity)
+        , m_size(0)
+        , m_dropped(0)
+        , m_thread(thread)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the index of the owning thread.
+    /// @return The index of the thread.
+    auto thread() const noexcept -> std::uint32_t { return m_thread; }
+
+    /// @brief Returns the number of events dropped because the buffer was full.
+    /// @return The number of events.
+    auto dropped() const noexcept -> std::uint64_t { return m_dropped; }
+
+    /// @brief Appends an event, or drops it if the buffer is full.
+    /// @param event The event.
+    void push(const TraceEvent &event) noexcept
+    {
+        if (m_size < m_capacity) {
+            m_events[m_size++] = event;
+        } else {
+            ++m_dropped;
+        }
+    }
+
+    /// @brief Visits the events, in the order they were recorded.
+    /// @param visit Function called as `visit(event)`.
+    template <class Visit>
+    void for_each(Visit &&visit) const
+    {
+        for (std::size_t i = 0; i < m_size; ++i) {
+            visit(m_events[i]);
+        }
+    }
+
+    /// @brief Removes the events, keeping the storage.
+    void clear() noexcept
+    {
+        m_size    = 0;
+        m_dropped = 0;
+    }
+
+private:
+    /// The events.
+    std::unique_ptr<TraceEvent[]> m_events;
+    /// The maximum number of events.
+    std::size_t m_capacity;
+    /// The number of events recorded.
+    std::size_t m_size;
+    /// The number of events dropped.
+    std::uint64_t m_dropped;
+    /// The index of the owning thread.
+    std::uint32_t m_thread;
+};
+
+/// @brief The buffers of all the threads which recorded events. A thread
+/// takes the lock only once, to register its buffer.
+class trace_registry
+{
+public:
+    /// @brief Returns the registry of the process.
+    /// @return The registry.
+    static auto instance() -> trace_registry &
+    {
+        static trace_registry registry;
+        return registry;
+    }
+
+    /// @brief Returns the time elapsed since the creation of the trace.
+    /// @return The time, in nanoseconds.
+    auto now() const noexcept -> std::uint64_t
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count());
+    }
+
+    /// @brief Sets the number of events the buffer of a thread holds, for the
+    /// threads which register afterwards (by default, 262144 events).
+    /// @param capacity The maximum number of events of a thread.
+    void set_capacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+    }
+
+    /// @brief Returns the buffer of the calling thread, registering it, and
+    /// allocating its storage, the first time.
+    /// @return The buffer.
+    auto local() -> trace_buffer &
+    {
+        thread_local trace_buffer *buffer = nullptr;
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffers.emplace_back(
+                std::make_unique<trace_buffer>(static_cast<std::uint32_t>(m_buffers.size()), m_capacity));
+            buffer = m_buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    /// @brief Returns the number of events dropped by all the threads, which
+    /// must not be recording, because their buffer was full.
+    /// @return The number of events.
+    auto dropped() const -> std::uint64_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint64_t count = 0;
+        for (const auto &buffer : m_buffers) {
+            count += buffer->dropped();
+        }
+        return count;
+    }
+
+    /// @brief Writes the events in the Chrome trace format. The threads must
+    /// not be recording while the events are written.
+    /// @param out The output stream.
+    void write_chrome_trace(std::ostream &out) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto &buffer : m_buffers) {
+            buffer->for_each([&](const TraceEvent &event) {
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << "{\"name\":\"" << event.name << "\",\"cat\":\"numint\",\"pid\":1,\"tid\":" << buffer->thread()
+                    << ",\"ts\":" << (event.begin / 1000) << '.' << digits(event.begin % 1000);
+                if (event.instant) {
+                    out << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"value\":" << event.value << "}}";
+                } else {
+                    out << ",\"ph\":\"X\",\"dur\":" << (event.duration / 1000) << '.'
+                        << digits(event.duration % 1000) << "}";
+                }
+            });
+        }
+        std::uint64_t dropped = 0;
+        for (const auto &buffer : m_buffers) {
+            dropped += buffer->dropped();
+        }
+        out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    }
+
+    /// @brief Writes the events in the Chrome trace format to a file. The
+    /// threads must not be recording while the events are written.
+    /// @param path The path of the file.
+    void write_chrome_trace(const std::string &path) const
+    {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Cannot create the trace file `" + path + "`.");
+        }
+        this->write_chrome_trace(out);
+    }
+
+    /// @brief Removes the events of all the threads, which must not be recording.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &buffer : m_buffers) {
+            buffer->clear();
+        }
+    }
+
+private:
+    /// @brief Creates an empty registry.
+    trace_registry()
+        : m_origin(std::chrono::steady_clock::now())
+        , m_capacity(262144)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Formats the three decimals of a time in microseconds.
+    /// @param nanoseconds The nanoseconds, below 1000.
+    /// @return The three digits.
+    static auto digits(std::uint64_t nanoseconds) -> std::string
+    {
+        std::string text = std::to_string(nanoseconds);
+        return std::string(3 - text.size(), '0') + text;
+    }
+
+    /// When the trace was created.
+    std::chrono::steady_clock::time_point m_origin;
+    /// The number of events of the buffers of the threads registering next.
+    std::size_t m_capacity;
+    /// Protects the list of buffers.
+    mutable std::mutex m_mutex;
+    /// The buffers of the threads.
+    std::vector<std::unique_ptr<trace_buffer>> m_buffers;
+};
+
+/// @brief Registers the calling thread, allocating its buffer up front, so
+/// that recording the first event of the thread does not allocate either.
+inline void trace_reserve() { trace_registry::instance().local(); }
+
+/// @brief Returns the time elapsed since the creation of the trace.
+/// @return The time, in nanoseconds.
+inline auto trace_now() noexcept -> std::uint64_t { return trace_registry::instance().now(); }
+
+/// @brief Records a span of the timeline, from the given time until now.
+/// @param name The name of the span, which must outlive the trace (e.g., a literal).
+/// @param begin When the span began, see `trace_now()`.
+inline void trace_complete(const char *name, std::uint64_t begin)
+{
+    trace_registry &registry = trace_registry::instance();
+    const std::uint64_t end  = registry.now();
+    registry.local().push(TraceEvent{name, begin, end - begin, 0., false});
+}
+
+/// @brief Records an instant event of the timeline.
+/// @param name The name of the event, which must outlive the trace (e.g., a literal).
+/// @param value The value of the event (e.g., the size of a step).
+inline void trace_instant(const char *name, double value)
+{
+    trace_registry &registry = trace_registry::instance();
+    registry.local().push(TraceEvent{name, registry.now(), 0, value, true});
+}
+
+/// @brief Writes the timeline of all the threads to a file, in the Chrome
+/// trace format. The threads must not be recording.
+/// @param path The path of the file.
+inline void write_chrome_trace(const std::string &path) { trace_registry::instance().write_chrome_trace(path); }
+
+/// @brief Evaluates the system, recorded as an "rhs" span of the timeline
+/// when `NUMINT_TRACE` is defined. Systems with a `set_stage` method (e.g.,
+/// `profiled_system`) are told which stage of the stepper evaluates them.
+/// @tparam System The type of the system.
+/// @tparam State The type of the state.
+/// @tparam Derivative The type of the derivative.
+/// @tparam Time The type of the time.
+/// @param system The system.
+/// @param x The state.
+/// @param dxdt The derivative, computed by the system.
+/// @param t The time.
+/// @param stage The stage of the stepper (e.g., "rk4.k2"), a literal.
+template <class System, class State, class Derivative, class Time>
+constexpr void call_system(System &&system, const State &x, Derivative &dxdt, Time t, const char *stage)
+{
+    if constexpr (has_set_stage_v<System>) {
+        system.set_stage(stage);
+    } else {
+        (void)stage;
+    }
+    NUMINT_TRACE_BEGIN(rhs);
+    std::forward<System>(system)(x, dxdt, t);
+    NUMINT_TRACE_END(rhs, "rhs");
+}
+
+/// @brief Tells a system with a `set_role` method (e.g., `profiled_system`)
+/// which of the steppers of a composite one evaluates it, does nothing otherwise.
+/// @tparam System The type of the system.
+/// @param system The system.
+/// @param role The role of the stepper (e.g., "main" or "tuner"), a literal, or nullptr.
+template <class System>
+constexpr void set_system_role(System &system, const char *role)
+{
+    if constexpr (has_set_role_v<System>) {
+        system.set_role(role);
+    } else {
+        (void)system, (void)role;
+    }
+}
+
+} // namespace numint::detail
@@ -0,0 +1,623 @@
+/// @file trajectory.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A binary file format for trajectories, with an observer writing it,
+/// and a reader which maps the file in memory, and can follow a file while it
+/// is still being written.
+///
+/// @details The file starts with a header, followed by fixed-size chunks. All
+/// the numbers are little-endian.
+///
+///     offset  size  content
+///     0       8     magic, "NUMINTTJ"
+///     8       4     version
+///     12      4     size of the time values, in bytes
+///     16      4     size of the state values, in bytes
+///     20      4     number of columns (the dimension of the state)
+///     24      4     number of rows of a chunk
+///     28      4     size of the header, in bytes, a multiple of 8
+///     32      8     number of rows written
+///     40      ...   the names of the columns, each one as a 4 bytes length
+///                   followed by the characters, padded with zeros
+///
+/// Each chunk holds the times of its rows, followed by each column of the
+/// state, so a chunk has always the same size, the last one being padded. The
+/// first time of each chunk, at a fixed offset, is the sparse index used to
+/// look up times. The number of rows is updated after the chunk it covers.
+
+#pragma once
+
+#include "numint/detail/observer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NUMINT_TRAJECTORY_MMAP
+#endif
+
+namespace numint::detail
+{
+
+namespace trajectory_format
+{
+
+/// The magic number at the beginning of the file.
+constexpr const char magic[8] = {'N', 'U', 'M', 'I', 'N', 'T', 'T', 'J'};
+/// The version of the format.
+constexpr std::uint32_t version      = 1;
+/// The offset of the number of rows.
+constexpr std::size_t rows_offset    = 32;
+/// The offset of the names of the columns.
+constexpr std::size_t names_offset   = 40;
+
+/// @brief Checks if the host is little-endian.
+/// @return true on little-endian hosts.
+inline auto is_little_endian() noexcept -> bool
+{
+    const std::uint16_t probe = 1;
+    unsigned char first       = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/// @brief Writes a value in little-endian order.
+/// @param destination Where to write the value.
+/// @param value The value.
+template <class T>
+inline void store(unsigned char *destination, const T &value) noexcept
+{
+    std::memcpy(destination, &value, sizeof(T));
+    if (!is_little_endian()) {
+        std::reverse(destination, destination + sizeof(T));
+    }
+}
+
+/// @brief Reads a value written in little-endian order.
+/// @param source Where to read the value from.
+/// @return The value.
+template <class T>
+inline auto load(const unsigned char *source) noexcept -> T
+{
+    T value;
+    if (is_little_endian()) {
+        std::memcpy(&value, source, sizeof(T));
+    } else {
+        unsigned char bytes[sizeof(T)];
+        std::reverse_copy(source, source + sizeof(T), bytes);
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+    return value;
+}
+
+/// @brief Rounds a size up to a multiple of 8.
+/// @param size The size.
+/// @return The rounded size.
+constexpr auto align(std::size_t size) noexcept -> std::size_t { return (size + 7U) & ~std::size_t(7U); }
+
+} // namespace trajectory_format
+
+/// @brief Observer that writes the trajectory to a binary file, see
+/// `trajectory.hpp` for the format.
+///
+/// @details The rows are gathered in a chunk in memory, which is written when
+/// full, followed by the updated number of rows, so that a reader following
+/// the file never sees a row before its data. `flush()` writes the partial
+/// chunk too, which is written again when more rows are added to it.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class ObserverTrajectory : public Observer<State, Time>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    /// @brief Creates the file.
+    /// @param path The path of the file.
+    /// @param names The names of the columns, if empty they are named after
+    /// their index, and the header is written at the first observation.
+    /// @param chunk_rows The number of rows of a chunk.
+    explicit ObserverTrajectory(
+        const std::string &path,
+        std::vector<std::string> names = std::vector<std::string>(),
+        std::size_t chunk_rows          = 1024)
+        : m_file(std::fopen(path.c_str(), "w+b"))
+        , m_names(std::move(names))
+        , m_chunk_rows(std::max<std::size_t>(chunk_rows, 1))
+        , m_header_size(0)
+        , m_chunk_size(0)
+        , m_rows(0)
+        , m_chunk_first(0)
+    {
+        if (m_file == nullptr) {
+            throw std::runtime_error("Cannot create the trajectory file `" + path + "`.");
+        }
+        // With the names, the header can be written right away, for the readers.
+        if (!m_names.empty()) {
+            this->write_header(m_names.size());
+        }
+    }
+
+    /// @brief Writes the rows left, and closes the file.
+    ~ObserverTrajectory()
+    {
+        try {
+            this->close();
+        } catch (...) {
+            // A destructor must not throw, call `close()` to see the errors.
+        }
+    }
+
+    /// @brief Copy constructor, deleted as the observer owns the file.
+    ObserverTrajectory(const ObserverTrajectory &other) = delete;
+
+    /// @brief Move constructor, deleted as the observer owns the file.
+    ObserverTrajectory(ObserverTrajectory &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the observer owns the file.
+    /// @return Reference to the observer.
+    auto operator=(const ObserverTrajectory &other) -> ObserverTrajectory & = delete;
+
+    /// @brief Move assignment operator, deleted as the observer owns the file.
+    /// @return Reference to the observer.
+    auto operator=(ObserverTrajectory &&other) -> ObserverTrajectory & = delete;
+
+    /// @brief Appends a row.
+    /// @param x The state vector, whose dimension must match the names.
+    /// @param t The time.
+    void operator()(const State &x, const Time &t)
+    {
+        if (m_header_size == 0) {
+            this->write_header(x.size());
+        } else if (x.size() != m_names.size()) {
+            throw std::runtime_error("The dimension of the state does not match the columns of the trajectory.");
+        }
+        const std::size_t row = m_rows - m_chunk_first;
+        trajectory_format::store(&m_chunk[row * sizeof(Time)], t);
+        unsigned char *values = m_chunk.data() + (m_chunk_rows * sizeof(Time)) + (row * sizeof(value_type));
+        for (std::size_t i = 0; i < m_names.size(); ++i) {
+            trajectory_format::store(values + (i * m_chunk_rows * sizeof(value_type)), static_cast<value_type>(x[i]));
+        }
+        if ((++m_rows - m_chunk_first) == m_chunk_rows) {
+            this->write_chunk();
+            m_chunk_first = m_rows;
+        }
+    }
+
+    /// @brief Writes the rows gathered so far, so that readers can see them.
+    void flush()
+    {
+        if ((m_file != nullptr) && (m_rows > m_chunk_first)) {
+            this->write_chunk();
+        }
+    }
+
+    /// @brief Writes the rows left, and closes the file.
+    void close()
+    {
+        if (m_file != nullptr) {
+            this->flush();
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    /// @brief Returns the number of rows written.
+    /// @return The number of rows.
+    auto size() const noexcept -> std::size_t { return m_rows; }
+
+private:
+    /// @brief Writes the header, once the dimension of the state is known.
+    /// @param columns The dimension of the state.
+    void write_header(std::size_t columns)
+    {
+        if (m_names.empty()) {
+            for (std::size_t i = 0; i < columns; ++i) {
+                m_names.emplace_back("x" + std::to_string(i));
+            }
+        }
+        if (m_names.size() != columns) {
+            throw std::runtime_error("The number of names does not match the dimension of the state.");
+        }
+        std::size_t size = trajectory_format::names_offset;
+        for (const auto &name : m_names) {
+            size += sizeof(std::uint32_t) + name.size();
+        }
+        m_header_size = trajectory_format::align(size);
+        m_chunk_size  = m_chunk_rows * (sizeof(Time) + (columns * sizeof(value_type)));
+        m_chunk.assign(m_chunk_size, 0);
+        // Fill the fields of the header, then append the names, and the padding.
+        unsigned char fields[trajectory_format::names_offset] = {};
+        std::memcpy(fields, trajectory_format::magic, sizeof(trajectory_format::magic));
+        trajectory_format::store(&fields[8], trajectory_format::version);
+        trajectory_format::store(&fields[12], static_cast<std::uint32_t>(sizeof(Time)));
+        trajectory_format::store(&fields[16], static_cast<std::uint32_t>(sizeof(value_type)));
+        trajectory_format::store(&fields[20], static_cast<std::uint32_t>(columns));
+        trajectory_format::store(&fields[24], static_cast<std::uint32_t>(m_chunk_rows));
+        trajectory_format::store(&fields[28], static_cast<std::uint32_t>(m_header_size));
+        trajectory_format::store(&fields[trajectory_format::rows_offset], std::uint64_t(0));
+        std::vector<unsigned char> header(fields, fields + sizeof(fields));
+        header.reserve(m_header_size);
+        for (const auto &name : m_names) {
+            unsigned char length[sizeof(std::uint32_t)];
+            trajectory_format::store(length, static_cast<std::uint32_t>(name.size()));
+            header.insert(header.end(), length, length + sizeof(length));
+            header.insert(header.end(), name.begin(), name.end());
+        }
+        header.resize(m_header_size, 0);
+        this->write_at(0, header.data(), header.size());
+        std::fflush(m_file);
+    }
+
+    /// @brief Writes the current chunk, and then the number of rows.
+    void write_chunk()
+    {
+        const std::size_t chunk = m_chunk_first / m_chunk_rows;
+        this->write_at(m_header_size + (chunk * m_chunk_size), m_chunk.data(), m_chunk.size());
+        unsigned char rows[sizeof(std::uint64_t)];
+        trajectory_format::store(rows, static_cast<std::uint64_t>(m_rows));
+        std::fflush(m_file);
+        this->write_at(trajectory_format::rows_offset, rows, sizeof(rows));
+        std::fflush(m_file);
+    }
+
+    /// @brief Writes data at the given position of the file.
+    /// @param offset The position.
+    /// @param data The data.
+    /// @param size The size of the data.
+    void write_at(std::size_t offset, const unsigned char *data, std::size_t size)
+    {
+#if defined(_MSC_VER)
+        const int moved = ::_fseeki64(m_file, static_cast<__int64>(offset), SEEK_SET);
+#elif defined(NUMINT_TRAJECTORY_MMAP)
+        const int moved = ::fseeko(m_file, static_cast<off_t>(offset), SEEK_SET);
+#else
+        const int moved = std::fseek(m_file, static_cast<long>(offset), SEEK_SET);
+#endif
+        if ((moved != 0) || (std::fwrite(data, 1, size, m_file) != size)) {
+            throw std::runtime_error("Cannot write the trajectory file.");
+        }
+    }
+
+    /// The file.
+    std::FILE *m_file;
+    /// The names of the columns.
+    std::vector<std::string> m_names;
+    /// The number of rows of a chunk.
+    std::size_t m_chunk_rows;
+    /// The size of the header, zero until it is written.
+    std::size_t m_header_size;
+    /// The size of a chunk.
+    std::size_t m_chunk_size;
+    /// The number of rows.
+    std::size_t m_rows;
+    /// The first row of the current chunk.
+    std::size_t m_chunk_first;
+    /// The current chunk.
+    std::vector<unsigned char> m_chunk;
+};
+
+/// @brief A view over a column of a trajectory file, which reads the values
+/// where they are, in the mapped file, without copying the column.
+/// @tparam T The type of the values.
+template <class T>
+class trajectory_column
+{
+public:
+    /// @brief Creates a new view.
+    /// @param first The first value of the first chunk.
+    /// @param chunk_size The size of a chunk, in bytes.
+    /// @param chunk_rows The number of rows of a chunk.
+    /// @param rows The number of rows.
+    trajectory_column(const unsigned char *first, std::size_t chunk_size, std::size_t chunk_rows, std::size_t rows)
+        : m_first(first)
+        , m_chunk_size(chunk_size)
+        , m_chunk_rows(chunk_rows)
+        , m_rows(rows)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of values.
+    /// @return The number of values.
+    auto size() const noexcept -> std::size_t { return m_rows; }
+
+    /// @brief Returns a value.
+    /// @param row The row of the value.
+    /// @return The value.
+    auto operator[](std::size_t row) const noexcept -> T
+    {
+        const std::size_t chunk = row / m_chunk_rows;
+        const std::size_t index = row - (chunk * m_chunk_rows);
+        return trajectory_format::load<T>(m_first + (chunk * m_chunk_size) + (index * sizeof(T)));
+    }
+
+private:
+    /// The first value of the first chunk.
+    const unsigned char *m_first;
+    /// The size of a chunk, in bytes.
+    std::size_t m_chunk_size;
+    /// The number of rows of a chunk.
+    std::size_t m_chunk_rows;
+    /// The number of rows.
+    std::size_t m_rows;
+};
+
+/// @brief Reads a trajectory file, see `trajectory.hpp` for the format.
+///
+/// @details The file is mapped in memory (read into memory where mapping is
+/// not available), and the columns are views over the mapping. The rows
+/// written after opening the file are seen after a call to `refresh()`, so a
+/// reader can follow a simulation in progress.
+///
+/// @tparam Value The type of the values of the state.
+/// @tparam Time The datatype used to hold time.
+template <class Value, class Time>
+class trajectory_reader
+{
+public:
+    /// @brief Opens the file, and reads its header.
+    /// @param path The path of the file.
+    explicit trajectory_reader(std::string path)
+        : m_path(std::move(path))
+        , m_data(nullptr)
+        , m_size(0)
+        , m_columns(0)
+        , m_chunk_rows(0)
+        , m_header_size(0)
+        , m_chunk_size(0)
+        , m_rows(0)
+    {
+        this->map();
+        // The destructor does not run if the constructor throws.
+        try {
+            this->read_header();
+            this->refresh();
+        } catch (...) {
+            this->unmap();
+            throw;
+        }
+    }
+
+    /// @brief Unmaps the file.
+    ~trajectory_reader() { this->unmap(); }
+
+    /// @brief Copy constructor, deleted as the reader owns the mapping.
+    trajectory_reader(const trajectory_reader &other) = delete;
+
+    /// @brief Move constructor, deleted as the columns point to the mapping.
+    trajectory_reader(trajectory_reader &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the reader owns the mapping.
+    /// @return Reference to the reader.
+    auto operator=(const trajectory_reader &other) -> trajectory_reader & = delete;
+
+    /// @brief Move assignment operator, deleted as the columns point to the mapping.
+    /// @return Reference to the reader.
+    auto operator=(trajectory_reader &&other) -> trajectory_reader & = delete;
+
+    /// @brief Looks for the rows written since the last call, mapping the
+    /// file again if it grew. The columns taken before are invalidated.
+    /// @return The number of rows.
+    auto refresh() -> std::size_t
+    {
+        std::size_t rows = this->read_rows();
+        if (this->required(rows) > m_size) {
+            this->unmap();
+            this->map();
+            rows = this->read_rows();
+        }
+        // Only the rows whose chunk is in the mapping.
+        while ((rows > 0) && (this->required(rows) > m_size)) {
+            rows = ((rows - 1) / m_chunk_rows) * m_chunk_rows;
+        }
+        m_rows = rows;
+        return m_rows;
+    }
+
+    /// @brief Returns the number of rows.
+    /// @return The number of rows.
+    auto size() const noexcept -> std::size_t { return m_rows; }
+
+    /// @brief Returns the number of columns, the time excluded.
+    /// @return The number of columns.
+    auto columns() const noexcept -> std::size_t { return m_columns; }
+
+    /// @brief Returns the names of the columns.
+    /// @return The names.
+    auto names() const -> const std::vector<std::string> & { return m_names; }
+
+    /// @brief Returns the times.
+    /// @return The view over the times.
+    auto time() const -> trajectory_column<Time>
+    {
+        return trajectory_column<Time>(m_data + m_header_size, m_chunk_size, m_chunk_rows, m_rows);
+    }
+
+    /// @brief Returns a column of the state.
+    /// @param index The index of the column.
+    /// @return The view over the column.
+    auto column(std::size_t index) const -> trajectory_column<Value>
+    {
+        const std::size_t offset =
+            m_header_size + (m_chunk_rows * sizeof(Time)) + (index * m_chunk_rows * sizeof(Value));
+        return trajectory_column<Value>(m_data + offset, m_chunk_size, m_chunk_rows, m_rows);
+    }
+
+    /// @brief Looks up the row whose time is the nearest to the given one,
+    /// first among the first times of the chunks, then inside the chunk.
+    /// @param t The time.
+    /// @return The index of the row, the size if there are no rows.
+    auto nearest(const Time &t) const -> std::size_t
+    {
+        if (m_rows == 0) {
+            return 0;
+        }
+        const auto times = this->time();
+        // Find the last chunk starting at or before the time.
+        std::size_t low = 0, high = ((m_rows - 1) / m_chunk_rows) + 1;
+        while ((high - low) > 1) {
+            const std::size_t middle = low + ((high - low) / 2);
+            if (t < times[middle * m_chunk_rows]) {
+                high = middle;
+            } else {
+                low = middle;
+            }
+        }
+        // Find the first row of the chunk at or after the time.
+        std::size_t first = low * m_chunk_rows, last = std::min(first + m_chunk_rows, m_rows);
+        while (first < last) {
+            const std::size_t middle = first + ((last - first) / 2);
+            if (times[middle] < t) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        // Pick the nearest between it and the previous one.
+        if (first == m_rows) {
+            return m_rows - 1;
+        }
+        if ((first > 0) && ((t - times[first - 1]) < (times[first] - t))) {
+            return first - 1;
+        }
+        return first;
+    }
+
+private:
+    /// @brief Reads the header.
+    void read_header()
+    {
+        if ((m_size < trajectory_format::names_offset) ||
+            (std::memcmp(m_data, trajectory_format::magic, sizeof(trajectory_format::magic)) != 0)) {
+            throw std::runtime_error("`" + m_path + "` is not a trajectory file.");
+        }
+        if (trajectory_format::load<std::uint32_t>(m_data + 8) != trajectory_format::version) {
+            throw std::runtime_error("`" + m_path + "` has an unsupported version.");
+        }
+        if ((trajectory_format::load<std::uint32_t>(m_data + 12) != sizeof(Time)) ||
+            (trajectory_format::load<std::uint32_t>(m_data + 16) != sizeof(Value))) {
+            throw std::runtime_error("`" + m_path + "` stores values of a different size.");
+        }
+        m_columns     = trajectory_format::load<std::uint32_t>(m_data + 20);
+        m_chunk_rows  = trajectory_format::load<std::uint32_t>(m_data + 24);
+        m_header_size = trajectory_format::load<std::uint32_t>(m_data + 28);
+        m_chunk_size  = m_chunk_rows * (sizeof(Time) + (m_columns * sizeof(Value)));
+        if ((m_chunk_rows == 0) || (m_header_size > m_size)) {
+            throw std::runtime_error("`" + m_path + "` has a corrupted header.");
+        }
+        std::size_t offset = trajectory_format::names_offset;
+        for (std::size_t i = 0; i < m_columns; ++i) {
+            const std::size_t length = trajectory_format::load<std::uint32_t>(m_data + offset);
+            offset += sizeof(std::uint32_t);
+            if ((offset + length) > m_header_size) {
+                throw std::runtime_error("`" + m_path + "` has a corrupted header.");
+            }
+            m_names.emplace_back(reinterpret_cast<const char *>(m_data + offset), length);
+            offset += length;
+        }
+    }
+
+    /// @brief Reads the number of rows written.
+    /// @return The number of rows.
+    auto read_rows() const -> std::size_t
+    {
+        return static_cast<std::size_t>(trajectory_format::load<std::uint64_t>(m_data + trajectory_format::rows_offset));
+    }
+
+    /// @brief Returns the size of the file holding the given rows.
+    /// @param rows The number of rows.
+    /// @return The size, in bytes.
+    auto required(std::size_t rows) const -> std::size_t
+    {
+        return m_header_size + (((rows + m_chunk_rows - 1) / m_chunk_rows) * m_chunk_size);
+    }
+
+#ifdef NUMINT_TRAJECTORY_MMAP
+    /// @brief Maps the file in memory.
+    void map()
+    {
+        const int descriptor = ::open(m_path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot open the trajectory file `" + m_path + "`.");
+        }
+        struct stat status {};
+        if ((::fstat(descriptor, &status) != 0) || (status.st_size <= 0)) {
+            ::close(descriptor);
+            throw std::runtime_error("Cannot read the trajectory file `" + m_path + "`.");
+        }
+        m_size       = static_cast<std::size_t>(status.st_size);
+        void *memory = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (memory == MAP_FAILED) {
+            throw std::runtime_error("Cannot map the trajectory file `" + m_path + "`.");
+        }
+        m_data = static_cast<const unsigned char *>(memory);
+    }
+
+    /// @brief Unmaps the file.
+    void unmap()
+    {
+        if (m_data != nullptr) {
+            ::munmap(const_cast<unsigned char *>(m_data), m_size);
+            m_data = nullptr;
+        }
+    }
+#else
+    /// @brief Reads the file in memory, where it cannot be mapped.
+    void map()
+    {
+        std::FILE *file = std::fopen(m_path.c_str(), "rb");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open the trajectory file `" + m_path + "`.");
+        }
+        m_buffer.clear();
+        unsigned char block[65536];
+        for (std::size_t count = 0; (count = std::fread(block, 1, sizeof(block), file)) > 0;) {
+            m_buffer.insert(m_buffer.end(), block, block + count);
+        }
+        std::fclose(file);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    /// @brief Releases the copy of the file.
+    void unmap() { m_data = nullptr; }
+
+    /// The copy of the file.
+    std::vector<unsigned char> m_buffer;
+#endif
+
+    /// The path of the file.
+    std::string m_path;
+    /// The content of the file.
+    const unsigned char *m_data;
+    /// The size of the content of the file.
+    std::size_t m_size;
+    /// The number of columns.
+    std::size_t m_columns;
+    /// The number of rows of a chunk.
+    std::size_t m_chunk_rows;
+    /// The size of the header.
+    std::size_t m_header_size;
+    /// The size of a chunk.
+    std::size_t m_chunk_size;
+    /// The number of rows.
+    std::size_t m_rows;
+    /// The names of the columns.
+    std::vector<std::string> m_names;
+};
+
+} // namespace numint::detail
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
 
 namespace numint::detail
@@ -26,4 +28,132 @@ struct has_resize<T, std::void_t<decltype(std::declval<T>().resize(1))>> : std::
 template <typename T>
 constexpr inline bool has_resize_v = has_resize<T>::value;
 
+/// @brief Checks if a type is a state, i.e., a container exposing its elements
+/// through a begin method.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct is_state : std::false_type {
+};
+
+/// @brief Checks if a type is a state, i.e., a container exposing its elements
+/// through a begin method.
+/// @tparam T The type to check.
+template <typename T>
+struct is_state<T, std::void_t<decltype(std::declval<T &>().begin())>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a type is a state.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool is_state_v = is_state<std::remove_cv_t<T>>::value;
+
+/// @brief Checks if a state stores its elements contiguously, i.e., it
+/// exposes them through a data method.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_data : std::false_type {
+};
+
+/// @brief Checks if a state stores its elements contiguously, i.e., it
+/// exposes them through a data method.
+/// @tparam T The type to check.
+template <typename T>
+struct has_data<T, std::void_t<decltype(std::declval<T &>().data())>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a state stores its elements contiguously.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_data_v = has_data<std::remove_cv_t<T>>::value;
+
+/// @brief Checks if a type has a size known at compile time (e.g.,
+/// `std::array`), through `std::tuple_size`.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_static_size : std::false_type {
+};
+
+/// @brief Checks if a type has a size known at compile time (e.g.,
+/// `std::array`), through `std::tuple_size`.
+/// @tparam T The type to check.
+template <typename T>
+struct has_static_size<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a type has a size known at compile time.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_static_size_v = has_static_size<std::remove_cv_t<T>>::value;
+
+/// @brief Checks if a type has a time member (e.g., a breakpoint of a schedule).
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_time_member : std::false_type {
+};
+
+/// @brief Checks if a type has a time member (e.g., a breakpoint of a schedule).
+/// @tparam T The type to check.
+template <typename T>
+struct has_time_member<T, std::void_t<decltype(std::declval<const T &>().time)>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a type has a time member.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_time_member_v = has_time_member<std::remove_cv_t<T>>::value;
+
+/// @brief Checks if a system wants to know which stage of a stepper
+/// evaluates it, through a set_stage method (e.g., `profiled_system`).
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_set_stage : std::false_type {
+};
+
+/// @brief Checks if a system wants to know which stage of a stepper
+/// evaluates it, through a set_stage method (e.g., `profiled_system`).
+/// @tparam T The type to check.
+template <typename T>
+struct has_set_stage<T, std::void_t<decltype(std::declval<T &>().set_stage(std::declval<const char *>()))>>
+    : std::true_type {
+};
+
+/// @brief Helper variable template to check if a system has a set_stage method.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_set_stage_v = has_set_stage<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+/// @brief Checks if a system wants to know which of the steppers of a
+/// composite one evaluates it, through a set_role method (e.g., `profiled_system`).
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_set_role : std::false_type {
+};
+
+/// @brief Checks if a system wants to know which of the steppers of a
+/// composite one evaluates it, through a set_role method (e.g., `profiled_system`).
+/// @tparam T The type to check.
+template <typename T>
+struct has_set_role<T, std::void_t<decltype(std::declval<T &>().set_role(std::declval<const char *>()))>>
+    : std::true_type {
+};
+
+/// @brief Helper variable template to check if a system has a set_role method.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_set_role_v = has_set_role<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+/// @brief Provides the scalar type underlying a state value type, which is
+/// the type itself unless specialized (e.g., for a batch of lanes).
+/// @tparam T The value type.
+template <typename T>
+struct scalar_type {
+    /// @brief The scalar type.
+    using type = T;
+};
+
+/// @brief Helper alias to retrieve the scalar type underlying a value type.
+/// @tparam T The value type.
+template <typename T>
+using scalar_type_t = typename scalar_type<T>::type;
+
 } // namespace numint::detail
\ No newline at end of file
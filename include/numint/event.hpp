@@ -0,0 +1,136 @@
+/// @file event.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Events are zero-crossings of a function of the state, such as a
+/// contact or a limit switch, which the solver locates in time and handles
+/// with a user action (e.g., resetting the state or terminating).
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace numint
+{
+
+/// Directions of the zero-crossings an event reacts to.
+enum class EventDirection : unsigned char {
+    Rising,  ///< From negative to positive values.
+    Falling, ///< From positive to negative values.
+    Both     ///< In both directions.
+};
+
+/// What the solver does after handling an event.
+enum class EventAction : unsigned char {
+    Continue, ///< Continue the integration, from the state left by the action.
+    Terminate ///< Stop the integration at the event.
+};
+
+/// @brief An event, defined by a function of the state whose zero-crossings
+/// trigger an action.
+/// @tparam Function The type of the event function, `value(state, time)`.
+/// @tparam Action The type of the action, `EventAction(state, time)`, which
+/// can modify the state (e.g., to reset it) and the model (e.g., to switch
+/// mode) before the integration continues.
+template <class Function, class Action>
+struct Event {
+    /// The event function.
+    Function function;
+    /// The action executed when the event is triggered.
+    Action action;
+    /// The direction of the zero-crossings that trigger the event.
+    EventDirection direction;
+};
+
+/// @brief Creates an event.
+/// @param function The event function, `value(state, time)`.
+/// @param action The action executed at the event, `EventAction(state, time)`.
+/// @param direction The direction of the zero-crossings that trigger the event.
+/// @return The event.
+template <class Function, class Action>
+constexpr auto make_event(Function function, Action action, EventDirection direction = EventDirection::Both)
+{
+    return Event<Function, Action>{std::move(function), std::move(action), direction};
+}
+
+namespace detail
+{
+
+/// @brief Checks if an event function crossed zero in the given direction.
+/// @param before The value of the function at the beginning of the step.
+/// @param after The value of the function at the end of the step.
+/// @param direction The direction of the zero-crossings to detect.
+/// @return true if the function crossed zero in the given direction.
+template <class T>
+constexpr auto is_crossing(T before, T after, EventDirection direction) noexcept -> bool
+{
+    const bool rising  = (before < T(0)) && (after >= T(0));
+    const bool falling = (before > T(0)) && (after <= T(0));
+    if (direction == EventDirection::Rising) {
+        return rising;
+    }
+    if (direction == EventDirection::Falling) {
+        return falling;
+    }
+    return rising || falling;
+}
+
+/// @brief Locates the zero-crossing of an event function inside a step, with
+/// the Illinois variant of the regula falsi.
+///
+/// @details The steppers have no dense output, so the function is evaluated
+/// by re-stepping from the state at the beginning of the step with shorter
+/// steps, which keeps the order of the stepper.
+///
+/// @param evaluate Function returning the value of the event function after a
+/// step of the given length from the beginning of the step.
+/// @param before The value of the function at the beginning of the step.
+/// @param after The value of the function at the end of the step.
+/// @param length The length of the step.
+/// @param tolerance The width of the final bracket.
+/// @param max_iterations The maximum number of iterations.
+/// @return The length of the shortest step after which the function has
+/// crossed zero, within the tolerance from the actual crossing.
+template <class Time, class T, class Evaluate>
+constexpr auto locate_crossing(
+    Evaluate &&evaluate,
+    T before,
+    T after,
+    Time length,
+    Time tolerance,
+    std::size_t max_iterations = 100) -> Time
+{
+    // The crossed side is the one with the opposite sign of the beginning.
+    const auto crossed = [before](T value) { return (before < T(0)) ? (value >= T(0)) : (value <= T(0)); };
+    // The bracket [a, b], with b always on the crossed side.
+    Time a = 0, b = length;
+    T fa = before, fb = after;
+    // The side that was moved last, to halve the value kept on the other.
+    int side = 0;
+    for (std::size_t iteration = 0; (iteration < max_iterations) && ((b - a) > tolerance); ++iteration) {
+        // Regula falsi, falling back on bisection when the secant leaves the
+        // bracket (or is not finite, when the secant is flat).
+        Time c = static_cast<Time>((a * fb - b * fa) / (fb - fa));
+        if (!(c > a) || !(c < b)) {
+            c = (a + b) / 2;
+        }
+        const T fc = evaluate(c);
+        if (crossed(fc)) {
+            b = c, fb = fc;
+            if (side == -1) {
+                fa /= 2;
+            }
+            side = -1;
+        } else {
+            a = c, fa = fc;
+            if (side == +1) {
+                fb /= 2;
+            }
+            side = +1;
+        }
+    }
+    return b;
+}
+
+} // namespace detail
+
+} // namespace numint
@@ -0,0 +1,67 @@
+/// @file arenstorf.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Arenstorf orbit, a periodic orbit of the restricted three-body
+/// problem (AREN in Hairer, Norsett and Wanner, "Solving Ordinary Differential
+/// Equations I"), whose close approaches to the Earth need small steps.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+namespace numint::problems
+{
+
+/// @brief The Arenstorf orbit of a satellite around the Earth and the Moon,
+/// over one period, after which it returns to its initial state.
+///     x[0], x[1] : Position.
+///     x[2], x[3] : Velocity.
+struct arenstorf {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 4>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "arenstorf";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = false;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, one period of the orbit.
+    static constexpr time_type end_time   = 17.0652165601579625588917206249;
+    /// @brief The reduced mass of the Moon.
+    static constexpr double mu            = 0.012277471;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {0.994, 0., 0., -2.00158510637908252240537862224}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type
+    {
+        return {0.99399999999990885, -3.0309430227421256e-13, -4.9285365806632294e-11, -2.0015851063932701};
+    }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        using std::sqrt;
+        const auto r1 = (x[0] + mu) * (x[0] + mu) + x[1] * x[1];
+        const auto r2 = (x[0] - (1. - mu)) * (x[0] - (1. - mu)) + x[1] * x[1];
+        const auto d1 = r1 * sqrt(r1);
+        const auto d2 = r2 * sqrt(r2);
+        dxdt[0]       = x[2];
+        dxdt[1]       = x[3];
+        dxdt[2]       = x[0] + 2. * x[3] - (1. - mu) * (x[0] + mu) / d1 - mu * (x[0] - (1. - mu)) / d2;
+        dxdt[3]       = x[1] - 2. * x[2] - (1. - mu) * x[1] / d1 - mu * x[1] / d2;
+    }
+};
+
+} // namespace numint::problems
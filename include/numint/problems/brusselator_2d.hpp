@@ -0,0 +1,136 @@
+/// @file brusselator_2d.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The two-dimensional Brusselator, a reaction-diffusion equation
+/// discretized in space by the method of lines (BRUSS-2D in Hairer and Wanner,
+/// "Solving Ordinary Differential Equations II"), whose size and stiffness
+/// grow with the grid.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace numint::problems
+{
+
+/// @brief The two-dimensional Brusselator, on the unit square with periodic
+/// boundaries, diffusion alpha = 0.1, and a forcing switched on at t = 1.1
+/// inside a disk, over [0, 11.5].
+///     x[2 * (i * N + j)]     : u at (x_j, y_i) = (j / N, i / N).
+///     x[2 * (i * N + j) + 1] : v at (x_j, y_i).
+struct brusselator_2d {
+    /// @brief The state vector type.
+    using state_type = std::vector<double>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name      = "brusselator_2d";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff         = true;
+    /// @brief The start time.
+    static constexpr time_type start_time  = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time    = 11.5;
+    /// @brief The grid of the reference state.
+    static constexpr std::size_t reference_grid = 8;
+    /// @brief The diffusion coefficient.
+    static constexpr double alpha          = 0.1;
+
+    /// @brief The number of points along each side of the grid.
+    std::size_t grid;
+
+    /// @brief Creates the problem.
+    /// @param _grid The number of points along each side of the grid, the
+    /// state has 2 * grid * grid elements.
+    explicit brusselator_2d(std::size_t _grid = reference_grid)
+        : grid(_grid)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type
+    {
+        state_type x(2 * grid * grid);
+        for (std::size_t i = 0; i < grid; ++i) {
+            const double y = static_cast<double>(i) / static_cast<double>(grid);
+            for (std::size_t j = 0; j < grid; ++j) {
+                const double z       = static_cast<double>(j) / static_cast<double>(grid);
+                x[2 * (i * grid + j)]     = 22. * y * std::pow(1. - y, 1.5);
+                x[2 * (i * grid + j) + 1] = 27. * z * std::pow(1. - z, 1.5);
+            }
+        }
+        return x;
+    }
+
+    /// @brief Returns the reference end state, known only for the reference grid.
+    /// @return The state at the end time, empty for another grid.
+    auto reference() const -> state_type
+    {
+        if (grid != reference_grid) {
+            return state_type();
+        }
+        return {0.62251147904014625, 4.8526165532356611, 0.66941599905098459, 4.8109823219803252, 0.70933585122245824,
+                4.7767333488565775, 0.70933585122245824, 4.7767333488565775, 0.66941599905098459, 4.8109823219803252,
+                0.62251147904014625, 4.8526165532356611, 0.59381009331836543, 4.8786453987195708, 0.59381009331836532,
+                4.8786453987195708, 0.60261419362325375, 4.8703283022094572, 0.6382657812823237, 4.8375736811893191,
+                0.66693310950612628, 4.8117592689058464, 0.66693310950612628, 4.8117592689058473, 0.6382657812823237,
+                4.83757368118932, 0.60261419362325375, 4.8703283022094572, 0.57995884525732344, 4.8914344609703919,
+                0.57995884525732344, 4.8914344609703919, 0.62251147904014625, 4.8526165532356611, 0.66941599905098459,
+                4.8109823219803252, 0.70933585122245824, 4.7767333488565775, 0.70933585122245812, 4.7767333488565775,
+                0.66941599905098448, 4.810982321980326, 0.62251147904014614, 4.8526165532356611, 0.59381009331836543,
+                4.8786453987195708, 0.59381009331836532, 4.8786453987195699, 0.67837018248994452, 4.8040613616609038,
+                0.76315029205641793, 4.7338813945817648, 0.84607532911587124, 4.6698059179104838, 0.84607532911587124,
+                4.6698059179104838, 0.76315029205641782, 4.7338813945817648, 0.67837018248994441, 4.8040613616609038,
+                0.63083186325886331, 4.8449555925727363, 0.63083186325886331, 4.8449555925727363, 0.75217526757721631,
+                4.7431911289060107, 0.90740741991060747, 4.6252713749969336, 1.0983422991517977, 4.4996000285775324,
+                1.0983422991517977, 4.4996000285775324, 0.90740741991060747, 4.6252713749969336, 0.75217526757721642,
+                4.7431911289060107, 0.67501057386229368, 4.805931901583933, 0.67501057386229379, 4.805931901583933,
+                0.79773536061234096, 4.7096243813270604, 1.0306098840920388, 4.5510742272246416, 1.4686652675136593,
+                4.3436691364824833, 1.4686652675136593, 4.3436691364824833, 1.0306098840920388, 4.5510742272246416,
+                0.79773536061234096, 4.7096243813270604, 0.6976456159945873, 4.7869693967513127, 0.6976456159945873,
+                4.7869693967513127, 0.75217526757721642, 4.7431911289060107, 0.90740741991060758, 4.6252713749969336,
+                1.0983422991517977, 4.4996000285775324, 1.0983422991517977, 4.4996000285775324, 0.90740741991060747,
+                4.6252713749969336, 0.75217526757721642, 4.7431911289060107, 0.67501057386229379, 4.805931901583933,
+                0.67501057386229379, 4.805931901583933, 0.67837018248994452, 4.8040613616609038, 0.76315029205641793,
+                4.7338813945817648, 0.84607532911587124, 4.6698059179104847, 0.84607532911587124, 4.6698059179104838,
+                0.76315029205641793, 4.7338813945817648, 0.67837018248994452, 4.8040613616609038, 0.63083186325886331,
+                4.8449555925727363, 0.63083186325886331, 4.8449555925727363};
+    }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        const double scale = alpha * static_cast<double>(grid) * static_cast<double>(grid);
+        const double h     = 1. / static_cast<double>(grid);
+        for (std::size_t i = 0; i < grid; ++i) {
+            const std::size_t up   = (i + 1) % grid;
+            const std::size_t down = (i + grid - 1) % grid;
+            const double y         = static_cast<double>(i) * h;
+            for (std::size_t j = 0; j < grid; ++j) {
+                const std::size_t right = (j + 1) % grid;
+                const std::size_t left  = (j + grid - 1) % grid;
+                const double z          = static_cast<double>(j) * h;
+                const std::size_t k     = 2 * (i * grid + j);
+                const auto u            = x[k];
+                const auto v            = x[k + 1];
+                const auto lap_u        = x[2 * (up * grid + j)] + x[2 * (down * grid + j)] +
+                                   x[2 * (i * grid + right)] + x[2 * (i * grid + left)] - 4. * u;
+                const auto lap_v = x[2 * (up * grid + j) + 1] + x[2 * (down * grid + j) + 1] +
+                                   x[2 * (i * grid + right) + 1] + x[2 * (i * grid + left) + 1] - 4. * v;
+                const bool forced = (t >= 1.1) && (((z - 0.3) * (z - 0.3) + (y - 0.6) * (y - 0.6)) <= 0.01);
+                dxdt[k]           = 1. + u * u * v - 4.4 * u + scale * lap_u + (forced ? 5. : 0.);
+                dxdt[k + 1]       = 3.4 * u - u * u * v + scale * lap_v;
+            }
+        }
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,61 @@
+/// @file hires.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The HIRES problem, the growth of plant tissue under light, a stiff
+/// test problem of eight reactions (HIRES in Hairer and Wanner, "Solving
+/// Ordinary Differential Equations II").
+
+#pragma once
+
+#include <array>
+
+namespace numint::problems
+{
+
+/// @brief The HIRES problem, over [0, 321.8122].
+struct hires {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 8>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "hires";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = true;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 321.8122;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {1., 0., 0., 0., 0., 0., 0., 0.0057}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type
+    {
+        return {0.00073713125733257032, 0.00014424857263161916, 5.8887297409676416e-05, 0.0011756513432831556,
+                0.0023863561988314397, 0.0062389682527431625, 0.0028499983951858262, 0.0028500016048141293};
+    }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = -1.71 * x[0] + 0.43 * x[1] + 8.32 * x[2] + 0.0007;
+        dxdt[1] = 1.71 * x[0] - 8.75 * x[1];
+        dxdt[2] = -10.03 * x[2] + 0.43 * x[3] + 0.035 * x[4];
+        dxdt[3] = 8.32 * x[1] + 1.71 * x[2] - 1.12 * x[3];
+        dxdt[4] = -1.745 * x[4] + 0.43 * x[5] + 0.43 * x[6];
+        dxdt[5] = -280. * x[5] * x[7] + 0.69 * x[3] + 1.71 * x[4] - 0.43 * x[5] + 0.69 * x[6];
+        dxdt[6] = 280. * x[5] * x[7] - 1.81 * x[6];
+        dxdt[7] = -dxdt[6];
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,53 @@
+/// @file lorenz.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Lorenz system, a classic chaotic non-stiff test problem (LRNZ
+/// in Hairer, Norsett and Wanner, "Solving Ordinary Differential Equations I").
+
+#pragma once
+
+#include <array>
+
+namespace numint::problems
+{
+
+/// @brief The Lorenz system, with sigma = 10, rho = 28 and beta = 8/3, from
+/// (-8, 8, 27) over [0, 16]. Being chaotic, the error of the end state grows
+/// with the local errors by several orders of magnitude.
+struct lorenz {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 3>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "lorenz";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = false;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 16.;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {-8., 8., 27.}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type { return {-9.1313130267790878, -12.476178810283509, 22.843338960369756}; }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = 10. * (x[1] - x[0]);
+        dxdt[1] = x[0] * (28. - x[2]) - x[1];
+        dxdt[2] = x[0] * x[1] - (8. / 3.) * x[2];
+    }
+};
+
+} // namespace numint::problems
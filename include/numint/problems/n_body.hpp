@@ -0,0 +1,118 @@
+/// @file n_body.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The gravitational N-body problem, and the outer solar system as its
+/// standard instance (Hairer, Lubich and Wanner, "Geometric Numerical
+/// Integration", Section I.2.4).
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace numint::problems
+{
+
+/// @brief The gravitational N-body problem in three dimensions.
+///     x[3 * i .. 3 * i + 2]                            : Position of the i-th body.
+///     x[3 * Bodies + 3 * i .. 3 * Bodies + 3 * i + 2]  : Velocity of the i-th body.
+/// @tparam Bodies The number of bodies.
+template <std::size_t Bodies>
+struct n_body {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 6 * Bodies>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The number of bodies.
+    static constexpr std::size_t bodies = Bodies;
+
+    /// @brief The masses of the bodies.
+    std::array<double, Bodies> masses;
+    /// @brief The gravitational constant.
+    double gravity;
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        using std::sqrt;
+        constexpr std::size_t v = 3 * Bodies;
+        for (std::size_t i = 0; i < v; ++i) {
+            dxdt[i]     = x[v + i];
+            dxdt[v + i] = 0.;
+        }
+        for (std::size_t i = 0; i < Bodies; ++i) {
+            for (std::size_t j = i + 1; j < Bodies; ++j) {
+                const auto dx = x[3 * j] - x[3 * i];
+                const auto dy = x[3 * j + 1] - x[3 * i + 1];
+                const auto dz = x[3 * j + 2] - x[3 * i + 2];
+                const auto r2 = dx * dx + dy * dy + dz * dz;
+                const auto f  = gravity / (r2 * sqrt(r2));
+                dxdt[v + 3 * i] += masses[j] * f * dx;
+                dxdt[v + 3 * i + 1] += masses[j] * f * dy;
+                dxdt[v + 3 * i + 2] += masses[j] * f * dz;
+                dxdt[v + 3 * j] -= masses[i] * f * dx;
+                dxdt[v + 3 * j + 1] -= masses[i] * f * dy;
+                dxdt[v + 3 * j + 2] -= masses[i] * f * dz;
+            }
+        }
+    }
+};
+
+/// @brief The outer solar system: the Sun (with the inner planets), Jupiter,
+/// Saturn, Uranus, Neptune and Pluto, in astronomical units, solar masses and
+/// Earth days, over 20000 days (almost five orbits of Jupiter).
+struct outer_solar_system : public n_body<6> {
+    /// @brief The name of the problem.
+    static constexpr const char *name = "outer_solar_system";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = false;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 20000.;
+
+    /// @brief Creates the problem.
+    outer_solar_system()
+        : n_body<6>{
+              {1.00000597682, 0.000954786104043, 0.000285583733151, 0.0000437273164546, 0.0000517759138449,
+               1. / 1.3e8},
+              2.95912208286e-4}
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type
+    {
+        return {// Positions.
+                0., 0., 0., -3.5023653, -3.8169847, -1.5507963, 9.0755314, -3.0458353, -1.6483708, 8.3101420,
+                -16.2901086, -7.2521278, 11.4707666, -25.7294829, -10.8169456, -15.5387357, -25.2225594, -3.1902382,
+                // Velocities.
+                0., 0., 0., 0.00565429, -0.00412490, -0.00190589, 0.00168318, 0.00483525, 0.00192462, 0.00354178,
+                0.00137102, 0.00055029, 0.00288930, 0.00114527, 0.00039677, 0.00276725, -0.00170702, -0.00136504};
+    }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type
+    {
+        return {0.1233322124142268, -0.058616808987360339, -0.028723538220436225, -0.77177837187818843,
+                4.6105538900447582, 1.9942337301316608, 3.9051292289435615, -8.5656319840330415, -3.7061413372003451,
+                -17.492834464533907, 4.3435345226942763, 2.1482606925001124, 18.051465002804875, 22.146025676860081,
+                8.6134820030396817, 37.285949448705708, -10.728138680006211, -14.55458380111844, 1.2153608108960401e-05,
+                -2.0358519838216747e-06, -1.1596289925535807e-06, -0.0075231871216586621, -0.00095047156667758576,
+                -0.0002243152819809747, 0.0048698144489546956, 0.0020114478852441171, 0.00062115001619608289,
+                -0.0010774480286725038, -0.0036480473659385058, -0.0015825685372962701, -0.0025198369859314694,
+                0.0017408452383549818, 0.00077519625287477691, 0.0014396172428636006, 0.0021721445224211957,
+                0.0002455229146265928};
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,52 @@
+/// @file orego.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Oregonator, a model of the Belousov-Zhabotinskii reaction, a
+/// stiff test problem with a periodic solution (OREGO in Hairer and Wanner,
+/// "Solving Ordinary Differential Equations II").
+
+#pragma once
+
+#include <array>
+
+namespace numint::problems
+{
+
+/// @brief The Oregonator, from (1, 2, 3) over [0, 360].
+struct orego {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 3>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "orego";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = true;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 360.;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {1., 2., 3.}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type { return {1.0008148703185227, 1228.1785215498924, 132.05549428465355}; }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = 77.27 * (x[1] + x[0] * (1. - 8.375e-06 * x[0] - x[1]));
+        dxdt[1] = (x[2] - (1. + x[0]) * x[1]) / 77.27;
+        dxdt[2] = 0.161 * (x[0] - x[2]);
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,89 @@
+/// @file pleiades.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Pleiades problem, seven stars in the plane attracting each other
+/// (PLEI in Hairer, Norsett and Wanner, "Solving Ordinary Differential
+/// Equations I"), with several close encounters.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace numint::problems
+{
+
+/// @brief The Pleiades problem, seven stars of mass 1 to 7, over [0, 3].
+///     x[0..6]   : Abscissae.
+///     x[7..13]  : Ordinates.
+///     x[14..20] : Horizontal velocities.
+///     x[21..27] : Vertical velocities.
+struct pleiades {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 28>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "pleiades";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = false;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 3.;
+    /// @brief The number of stars.
+    static constexpr std::size_t stars    = 7;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type
+    {
+        return {3., 3., -1., -3., 2., -2., 2., 3., -3., 2., 0., 0., -4., 4.,
+                0., 0., 0., 0., 0., 1.75, -1.5, 0., 0., 0., -1.25, 1., 0., 0.};
+    }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type
+    {
+        return {0.37061391439705127, 3.2372840920572332, -3.2225590324183235, 0.6597091455775308, 0.34255817071565797,
+                1.5621721014006311, -0.70030929222124949, -3.9434375855173922, -3.2713809739725499, 5.225081843456544,
+                -2.5906124349774693, 1.1982136933922747, -0.24296823449358235, 1.0914492404289797, 3.4170038063143147,
+                1.3545845016255011, -2.5900655978107756, 2.0250537347142412, -1.1558151001604491, -0.80729881702230222,
+                0.59523963542087188, -3.7412449612340084, 0.37734596857506292, 0.93868588695510791, 0.36679222272005696,
+                -0.34740463538084942, 2.3449154481809371, -1.947020434263292};
+    }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        using std::sqrt;
+        for (std::size_t i = 0; i < stars; ++i) {
+            dxdt[i]               = x[(2 * stars) + i];
+            dxdt[stars + i]       = x[(3 * stars) + i];
+            dxdt[(2 * stars) + i] = 0.;
+            dxdt[(3 * stars) + i] = 0.;
+        }
+        for (std::size_t i = 0; i < stars; ++i) {
+            for (std::size_t j = i + 1; j < stars; ++j) {
+                const auto dx = x[j] - x[i];
+                const auto dy = x[stars + j] - x[stars + i];
+                const auto r2 = dx * dx + dy * dy;
+                const auto r3 = r2 * sqrt(r2);
+                // The mass of the k-th star is k + 1.
+                dxdt[(2 * stars) + i] += static_cast<double>(j + 1) * dx / r3;
+                dxdt[(3 * stars) + i] += static_cast<double>(j + 1) * dy / r3;
+                dxdt[(2 * stars) + j] -= static_cast<double>(i + 1) * dx / r3;
+                dxdt[(3 * stars) + j] -= static_cast<double>(i + 1) * dy / r3;
+            }
+        }
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,52 @@
+/// @file robertson.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Robertson chemical reaction, a classic stiff test problem (ROBER
+/// in Hairer and Wanner, "Solving Ordinary Differential Equations II").
+
+#pragma once
+
+#include <array>
+
+namespace numint::problems
+{
+
+/// @brief The Robertson reaction of three species, whose rate constants span
+/// nine orders of magnitude, over [0, 40].
+struct robertson {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 3>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "robertson";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = true;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 40.;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {1., 0., 0.}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type { return {0.71582706871940593, 9.1855347645577948e-06, 0.28416374574582937}; }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = -0.04 * x[0] + 1e04 * x[1] * x[2];
+        dxdt[1] = 0.04 * x[0] - 1e04 * x[1] * x[2] - 3e07 * x[1] * x[1];
+        dxdt[2] = 3e07 * x[1] * x[1];
+    }
+};
+
+} // namespace numint::problems
@@ -0,0 +1,54 @@
+/// @file van_der_pol.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief The Van der Pol oscillator with a large damping, a classic stiff test
+/// problem (VDPOL in Hairer and Wanner, "Solving Ordinary Differential
+/// Equations II"), with slow phases and very fast transitions.
+
+#pragma once
+
+#include <array>
+
+namespace numint::problems
+{
+
+/// @brief The Van der Pol oscillator in Lienard's scaled time, with
+/// mu = 1e6 (i.e., epsilon = 1e-6), from (2, -0.66) over [0, 2].
+struct van_der_pol {
+    /// @brief The state vector type.
+    using state_type = std::array<double, 2>;
+    /// @brief Type used to keep track of time.
+    using time_type  = double;
+
+    /// @brief The name of the problem.
+    static constexpr const char *name = "van_der_pol";
+    /// @brief Indicates whether the problem is stiff.
+    static constexpr bool is_stiff    = true;
+    /// @brief The start time.
+    static constexpr time_type start_time = 0.;
+    /// @brief The end time, of the reference state.
+    static constexpr time_type end_time   = 2.;
+    /// @brief The damping.
+    static constexpr double mu            = 1e06;
+
+    /// @brief Returns the initial state.
+    /// @return The state at the start time.
+    auto initial_state() const -> state_type { return {2., -0.66}; }
+
+    /// @brief Returns the reference end state.
+    /// @return The state at the end time.
+    auto reference() const -> state_type { return {1.706167437543217, -0.89281001655107628}; }
+
+    /// @brief Computes the derivative.
+    /// @param x The state.
+    /// @param dxdt The derivative.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = x[1];
+        dxdt[1] = mu * ((1. - x[0] * x[0]) * x[1] - x[0]);
+    }
+};
+
+} // namespace numint::problems
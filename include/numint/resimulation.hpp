@@ -0,0 +1,270 @@
+/// @file resimulation.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Incremental "what-if" re-simulation: a cache of snapshots taken
+/// while integrating a schedule, from which a run differing only after some
+/// time restarts, reusing the trajectory computed before it.
+
+#pragma once
+
+#include "numint/detail/checkpoint.hpp"
+#include "numint/solver.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief Cache of the snapshots taken by `integrate_schedule_cached`.
+///
+/// @details A snapshot holds the state, the time, the size of the next step,
+/// the state of the stepper, and the rows observed since the previous snapshot
+/// of the same run. It is keyed by a hash of everything which determined the
+/// integration up to its time: the parameters of the model, the initial
+/// conditions, the settings of the stepper, the breakpoints already applied,
+/// and the time of the next one (which bounds the steps). A run which only
+/// differs after a given time shares the keys of all the snapshots before it.
+///
+/// @tparam Stepper The type of the integration stepper.
+template <class Stepper>
+class resimulation_cache
+{
+public:
+    /// @brief The state vector type.
+    using state_type = typename Stepper::state_type;
+    /// @brief Type used to keep track of time.
+    using time_type  = typename Stepper::time_type;
+
+    /// @brief Index of a missing snapshot.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// @brief A snapshot of a run.
+    struct snapshot {
+        /// The hash of the inputs which determined the run up to the snapshot.
+        std::uint64_t key;
+        /// The previous snapshot of the run, `npos` for the first one.
+        std::size_t parent;
+        /// The number of breakpoints applied.
+        std::size_t breakpoints;
+        /// The time.
+        time_type time;
+        /// The size of the next step.
+        time_type time_delta;
+        /// The state of the system.
+        state_type state;
+        /// The state of the stepper.
+        std::vector<char> stepper;
+        /// The rows observed since the previous snapshot, this one included.
+        std::vector<std::pair<state_type, time_type>> rows;
+    };
+
+    /// @brief Creates an empty cache.
+    /// @param interval The simulated time between two snapshots of a run.
+    explicit resimulation_cache(time_type interval)
+        : m_interval(interval)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the simulated time between two snapshots of a run.
+    /// @return The interval.
+    auto interval() const -> time_type { return m_interval; }
+
+    /// @brief Returns the snapshots.
+    /// @return The snapshots.
+    auto snapshots() const -> const std::vector<snapshot> & { return m_snapshots; }
+
+    /// @brief Looks for the latest snapshot a run can restart from.
+    /// @param keys The keys of the run, the i-th one holding after applying i breakpoints.
+    /// @return The index of the snapshot, or `npos`.
+    auto find(const std::vector<std::uint64_t> &keys) const -> std::size_t
+    {
+        std::size_t found = npos;
+        for (std::size_t i = 0; i < m_snapshots.size(); ++i) {
+            const snapshot &candidate = m_snapshots[i];
+            if ((candidate.breakpoints < keys.size()) && (keys[candidate.breakpoints] == candidate.key) &&
+                ((found == npos) || (m_snapshots[found].time < candidate.time))) {
+                found = i;
+            }
+        }
+        return found;
+    }
+
+    /// @brief Adds a snapshot.
+    /// @param entry The snapshot.
+    /// @return Its index.
+    auto insert(snapshot entry) -> std::size_t
+    {
+        m_snapshots.emplace_back(std::move(entry));
+        return m_snapshots.size() - 1;
+    }
+
+    /// @brief Passes the rows observed up to a snapshot to an observer, in order.
+    /// @param index The index of the snapshot.
+    /// @param observer The observer.
+    template <class Observer>
+    void replay(std::size_t index, Observer &&observer) const
+    {
+        std::vector<std::size_t> chain;
+        for (; index != npos; index = m_snapshots[index].parent) {
+            chain.emplace_back(index);
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            for (const auto &[x, t] : m_snapshots[*it].rows) {
+                observer(x, t);
+            }
+        }
+    }
+
+    /// @brief Removes all the snapshots.
+    void clear() { m_snapshots.clear(); }
+
+private:
+    /// The simulated time between two snapshots of a run.
+    time_type m_interval;
+    /// The snapshots.
+    std::vector<snapshot> m_snapshots;
+};
+
+/// @brief Integrates the system through a schedule of breakpoints, like
+/// `integrate_schedule`, restarting from the cached snapshot of an earlier run
+/// when the two runs only differ after it.
+///
+/// @details The typical use is a "what-if" study, where a breakpoint late in
+/// the schedule changes (e.g., the mode of the fourth segment): the keys of
+/// the run are compared with the ones of the snapshots, the integration
+/// restarts from the latest snapshot they share, and the observer first
+/// receives the rows cached up to it. The result is the same, bit by bit, as
+/// integrating the schedule from the start. On restart, the updates of the
+/// breakpoints before the snapshot are replayed on a copy of the state, to
+/// bring the model (e.g., its mode) where it was, without touching the state.
+/// Anything else that affects the model must be part of `parameters`. The
+/// stepper enters the keys through its settings alone (see
+/// `stepper_adaptive::save_settings`), hence the same stepper can be reused
+/// across runs.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam Schedule A range of breakpoints sorted by time, each exposing a
+/// `time` and a `value` member, e.g., `Breakpoint`, whose value supports `std::hash`.
+/// @tparam Update The type of the function applying a breakpoint.
+///
+/// @param cache The cache of snapshots, extended with the ones of this run.
+/// @param stepper The stepper used to perform the integration, with its settings.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration, later breakpoints are ignored.
+/// @param time_delta The initial step size for integration.
+/// @param parameters A hash of the parameters of the model which are not part of the schedule.
+/// @param schedule The breakpoints, the ones before the start time are applied immediately.
+/// @param update Function called as `update(breakpoint, state)` when the
+/// integration reaches a breakpoint, before integrating past it.
+///
+/// @return The time the integration restarted from, `start_time` if no snapshot was reused.
+template <class Stepper, class System, class Observer, class Schedule, class Update>
+auto integrate_schedule_cached(
+    resimulation_cache<Stepper> &cache,
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    std::uint64_t parameters,
+    const Schedule &schedule,
+    Update &&update) -> typename Stepper::time_type
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    using cache_type = resimulation_cache<Stepper>;
+    using value_type = std::decay_t<decltype(std::begin(schedule)->value)>;
+
+    // Adjust the stepper's internal size once, for all the segments.
+    if constexpr (numint::detail::has_resize_v<state_type>) {
+        stepper.adjust_size(state);
+    }
+    // Compute the key of the run after each breakpoint: first the inputs
+    // fixed at the start, then the breakpoints applied, and the time of the
+    // next one, which is where the steps have to land.
+    detail::checkpoint_writer inputs;
+    inputs.write(parameters);
+    inputs.write(start_time);
+    inputs.write(end_time);
+    inputs.write(time_delta);
+    inputs.write_state(state);
+    // Only the settings of the stepper, not what it did in earlier runs (its
+    // steps, its last error, its statistics), which would make every run of
+    // a reused stepper miss the cache: the steps do not depend on it.
+    if constexpr (Stepper::is_adaptive_stepper) {
+        stepper.save_settings(inputs);
+    }
+    std::vector<std::uint64_t> keys;
+    std::uint64_t key = detail::checkpoint_format::hash(inputs.data().data(), inputs.data().size());
+    for (auto it = std::begin(schedule);; ++it) {
+        detail::checkpoint_writer next;
+        next.write(key);
+        next.write(static_cast<time_type>((it != std::end(schedule)) ? time_type(it->time) : end_time));
+        keys.emplace_back(detail::checkpoint_format::hash(next.data().data(), next.data().size()));
+        if (it == std::end(schedule)) {
+            break;
+        }
+        next.write(static_cast<std::uint64_t>(std::hash<value_type>()(it->value)));
+        key = detail::checkpoint_format::hash(next.data().data(), next.data().size());
+    }
+    // Restart from the latest snapshot shared with an earlier run.
+    std::size_t parent = cache.find(keys);
+    auto breakpoint    = std::begin(schedule);
+    if (parent == cache_type::npos) {
+        std::forward<Observer>(observer)(state, start_time);
+    } else {
+        const auto &restart = cache.snapshots()[parent];
+        cache.replay(parent, std::forward<Observer>(observer));
+        // Bring the model where it was, leaving the state alone.
+        state_type scratch(restart.state);
+        for (std::size_t i = 0; i < restart.breakpoints; ++i, ++breakpoint) {
+            update(*breakpoint, scratch);
+        }
+        detail::checkpoint_reader reader;
+        reader.assign(restart.stepper);
+        stepper.load(reader);
+        state      = restart.state;
+        start_time = restart.time;
+        time_delta = restart.time_delta;
+    }
+    // Record the rows, and take a snapshot at each interval.
+    std::vector<std::pair<state_type, time_type>> rows;
+    if (parent == cache_type::npos) {
+        rows.emplace_back(state, start_time);
+    }
+    time_type last_snapshot = start_time;
+    const auto record       = [&](const state_type &x, const time_type &t) {
+        rows.emplace_back(x, t);
+        std::forward<Observer>(observer)(x, t);
+    };
+    const auto take_snapshot = [&](const state_type &x, time_type t, time_type dt, auto next) {
+        if ((t - last_snapshot) < cache.interval()) {
+            return;
+        }
+        const auto applied = static_cast<std::size_t>(std::distance(std::begin(schedule), next));
+        detail::checkpoint_writer writer;
+        stepper.save(writer);
+        parent = cache.insert({keys[applied], parent, applied, t, dt, x, writer.data(), std::move(rows)});
+        rows.clear();
+        last_snapshot = t;
+    };
+    detail::integrate_schedule_from(
+        stepper, record, std::forward<System>(system), state, start_time, end_time, time_delta, breakpoint,
+        std::end(schedule), std::forward<Update>(update), take_snapshot);
+    return start_time;
+}
+
+} // namespace numint
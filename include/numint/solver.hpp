@@ -5,9 +5,23 @@
 
 #pragma once
 
+#include "numint/detail/checkpoint.hpp"
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/landing_step.hpp"
 #include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
+#include "numint/event.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 enum : unsigned char {
     NUMINT_MAJOR_VERSION = 1, ///< Major version of the library.
@@ -18,6 +32,17 @@ enum : unsigned char {
 namespace numint
 {
 
+/// @brief A breakpoint of a schedule, see `integrate_schedule`.
+/// @tparam Time The type used to keep track of time.
+/// @tparam Value The type of what changes at the breakpoint (e.g., a mode).
+template <class Time, class Value>
+struct Breakpoint {
+    /// The time of the breakpoint.
+    Time time;
+    /// What changes at the breakpoint.
+    Value value;
+};
+
 namespace detail
 {
 
@@ -50,7 +75,9 @@ constexpr void integrate_one_step(
     // Perform one integration step.
     stepper.do_step(std::forward<System>(system), state, time, time_delta);
     // Call the observer.
+    NUMINT_TRACE_BEGIN(observer);
     std::forward<Observer>(observer)(state, time);
+    NUMINT_TRACE_END(observer, "observer");
 }
 
 /// @brief Default termination condition that never ends early.
@@ -72,6 +99,92 @@ constexpr auto default_termination_condition(const State &state) noexcept -> boo
     return false;
 }
 
+/// @brief Returns the time of a breakpoint.
+/// @tparam Breakpoint Either a type with a `time` member (e.g., `Breakpoint`),
+/// or the time itself (e.g., a time stop).
+/// @param breakpoint The breakpoint.
+/// @return The time of the breakpoint.
+template <class Breakpoint>
+constexpr auto breakpoint_time(const Breakpoint &breakpoint)
+{
+    if constexpr (has_time_member_v<Breakpoint>) {
+        return breakpoint.time;
+    } else {
+        return breakpoint;
+    }
+}
+
+/// @brief The loop of `integrate_schedule`, starting from the given breakpoint.
+///
+/// @details The observer is not called at the beginning. After each step,
+/// `hook(state, time, time_delta, breakpoint)` receives everything needed to
+/// continue the integration later from that point: the state, the time, the
+/// size of the next step, and the next breakpoint to apply. A hook returning
+/// a `bool` stops the integration by returning true.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam Iterator An iterator over breakpoints sorted by time, see `breakpoint_time`.
+/// @tparam Update The type of the function applying a breakpoint.
+/// @tparam Hook The type of the function called after each step.
+///
+/// @param stepper The stepper used to perform the integration, already sized.
+/// @param observer The observer function to call after each step.
+/// @param system The system being integrated.
+/// @param state The state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The size of the next step.
+/// @param breakpoint The next breakpoint to apply.
+/// @param last The end of the breakpoints.
+/// @param update Function called as `update(breakpoint, state)`.
+/// @param hook Function called after each step.
+template <class Stepper, class System, class Observer, class Iterator, class Update, class Hook>
+constexpr void integrate_schedule_from(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    Iterator breakpoint,
+    Iterator last,
+    Update &&update,
+    Hook &&hook)
+{
+    using time_type = typename Stepper::time_type;
+
+    while (true) {
+        // Apply the breakpoints we reached.
+        while ((breakpoint != last) && !(start_time < breakpoint_time(*breakpoint))) {
+            update(*breakpoint, state);
+            ++breakpoint;
+        }
+        if (!(start_time < end_time)) {
+            break;
+        }
+        // Integrate up to the next breakpoint, or to the end.
+        const time_type segment_end = ((breakpoint != last) && (breakpoint_time(*breakpoint) < end_time))
+                                          ? time_type(breakpoint_time(*breakpoint))
+                                          : end_time;
+        while (start_time < segment_end) {
+            detail::landing_step(stepper, std::forward<System>(system), state, start_time, time_delta, segment_end);
+            // Call the observer.
+            std::forward<Observer>(observer)(state, start_time);
+            // Let the caller inspect the integration between two steps.
+            if constexpr (std::is_same_v<decltype(hook(state, start_time, time_delta, breakpoint)), bool>) {
+                if (hook(state, start_time, time_delta, breakpoint)) {
+                    return;
+                }
+            } else {
+                hook(state, start_time, time_delta, breakpoint);
+            }
+        }
+    }
+}
+
 } // namespace detail
 
 /// @brief Integrates the system over a fixed time step between the start and end time.
@@ -112,6 +225,7 @@ constexpr auto integrate_fixed(
     TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>) noexcept
 {
     using state_type = typename Stepper::state_type;
+    NUMINT_TRACE_BEGIN(integrate);
     // Check if the state vector can (and should) be resized.
     if constexpr (numint::detail::has_resize_v<state_type>) {
         stepper.adjust_size(state);
@@ -130,6 +244,7 @@ constexpr auto integrate_fixed(
             break; // Terminate the integration early.
         }
     }
+    NUMINT_TRACE_END(integrate, "integrate_fixed");
     // Return the number of steps it took to integrate.
     return stepper.steps();
 }
@@ -163,7 +278,8 @@ template <
     class Stepper,
     class System,
     class Observer,
-    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>),
+    std::enable_if_t<std::is_invocable_v<TerminationCondition &, const typename Stepper::state_type &>, int> = 0>
 constexpr auto integrate_adaptive(
     Stepper &stepper,
     Observer &&observer,
@@ -175,6 +291,7 @@ constexpr auto integrate_adaptive(
     TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>)
 {
     using state_type = typename Stepper::state_type;
+    NUMINT_TRACE_BEGIN(integrate);
 
     // Adjust the stepper's internal size if the state supports resizing.
     if constexpr (numint::detail::has_resize_v<state_type>) {
@@ -204,6 +321,421 @@ constexpr auto integrate_adaptive(
     }
     // Call the observer one last time.
     std::forward<Observer>(observer)(state, start_time);
+    NUMINT_TRACE_END(integrate, "integrate_adaptive");
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+/// @brief Integrates the system from the start time to the end time using an
+/// adaptive stepper, without stepping across the given time stops.
+///
+/// @details The time stops are the known discontinuities of the system (e.g.,
+/// the times at which a piecewise constant input changes). The integration
+/// lands exactly on each of them, which replaces the repeated step shrinking
+/// the controller would need to detect the discontinuity. The steps are the
+/// ones of `integrate_schedule` with a schedule of time stops: the step size
+/// carries over from one segment to the next, and the steps shortened to land
+/// on a time stop can only reduce it. The observer is called at the beginning,
+/// and after each step.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam TimeStops A range of times, sorted in increasing order.
+/// @tparam TerminationCondition The type of the termination condition function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration, it must follow the start time.
+/// @param time_delta The initial step size for integration.
+/// @param tstops The time stops, the ones outside of the integration interval are ignored.
+/// @param check_if_done The termination condition to determine if integration
+/// should stop early. Defaults to a function that always returns false.
+///
+/// @return The number of steps taken to complete the integration.
+template <
+    class Stepper,
+    class System,
+    class Observer,
+    class TimeStops,
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>),
+    std::enable_if_t<!std::is_invocable_v<const TimeStops &, const typename Stepper::state_type &>, int> = 0>
+constexpr auto integrate_adaptive(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const TimeStops &tstops,
+    TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    NUMINT_TRACE_BEGIN(integrate);
+
+    // Adjust the stepper's internal size if the state supports resizing.
+    if constexpr (numint::detail::has_resize_v<state_type>) {
+        stepper.adjust_size(state);
+    }
+    // Call the observer at the beginning.
+    std::forward<Observer>(observer)(state, start_time);
+    // The time stops are a schedule with nothing to apply.
+    detail::integrate_schedule_from(
+        stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, end_time,
+        time_delta, std::begin(tstops), std::end(tstops), [](const auto &, state_type &) {},
+        [&check_if_done](const state_type &x, time_type, time_type, auto) -> bool { return check_if_done(x); });
+    NUMINT_TRACE_END(integrate, "integrate_adaptive");
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+/// @brief Integrates the system from the start time to the end time, while
+/// locating the zero-crossings of the given events and running their actions.
+///
+/// @details After each step, the event functions are evaluated on the new
+/// state. When one or more of them crossed zero in their direction, the
+/// crossings are located within `event_tolerance` by re-stepping from the
+/// state at the beginning of the step, the integration moves to the earliest
+/// one, and its action is executed. The action can modify the state (e.g., to
+/// reset it) and the model, and decides whether to continue or to terminate.
+/// Works with both fixed and adaptive steppers, the latter keep controlling
+/// the step size.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam Events The types of the events, see `make_event`.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, and at each event.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The (initial) step size for integration.
+/// @param event_tolerance The accuracy with which the events are located in time.
+/// @param events The events.
+///
+/// @return The number of steps taken to complete the integration, including
+/// the ones used to locate the events.
+template <class Stepper, class System, class Observer, class... Events>
+constexpr auto integrate_events(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    typename Stepper::time_type event_tolerance,
+    Events &&...events)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    using value_type = typename Stepper::value_type;
+
+    // Adjust the stepper's internal size if the state supports resizing.
+    if constexpr (numint::detail::has_resize_v<state_type>) {
+        stepper.adjust_size(state);
+    }
+    // The state at the beginning of the step, and the one used to locate the events.
+    state_type begin_state(state), trial_state(state);
+    // The values of the event functions at the beginning and at the end of the step.
+    std::array<value_type, sizeof...(Events)> before{static_cast<value_type>(events.function(state, start_time))...};
+    std::array<value_type, sizeof...(Events)> after{};
+    // Call the observer at the beginning.
+    std::forward<Observer>(observer)(state, start_time);
+    // Run until the time reaches the `end_time`.
+    while (start_time < end_time) {
+        // Make sure we don't go beyond the end_time.
+        const time_type step = std::min(time_delta, end_time - start_time);
+        // Perform one integration step, keeping the initial state aside.
+        begin_state = state;
+        stepper.do_step(std::forward<System>(system), state, start_time, step);
+        // Adaptive steppers provide the size of the next step.
+        if constexpr (Stepper::is_adaptive_stepper) {
+            time_delta = stepper.get_time_delta();
+        }
+        // Evaluate the event functions at the end of the step.
+        after = {static_cast<value_type>(events.function(state, start_time + step))...};
+        // Locate the earliest event triggered during the step.
+        std::size_t triggered = sizeof...(Events), index = 0;
+        time_type earliest    = step;
+        const auto locate     = [&](auto &event) {
+            if (detail::is_crossing(before[index], after[index], event.direction)) {
+                const time_type length = detail::locate_crossing<time_type>(
+                    [&](time_type trial_step) {
+                        trial_state = begin_state;
+                        stepper.do_step(std::forward<System>(system), trial_state, start_time, trial_step);
+                        return static_cast<value_type>(event.function(trial_state, start_time + trial_step));
+                    },
+                    before[index], after[index], step, event_tolerance);
+                if ((triggered == sizeof...(Events)) || (length < earliest)) {
+                    triggered = index, earliest = length;
+                }
+            }
+            ++index;
+        };
+        (locate(events), ...);
+        // Without events, move on to the next step.
+        if (triggered == sizeof...(Events)) {
+            start_time += step;
+            before = after;
+            std::forward<Observer>(observer)(state, start_time);
+            continue;
+        }
+        // Move to the event.
+        state = begin_state;
+        stepper.do_step(std::forward<System>(system), state, start_time, earliest);
+        start_time += earliest;
+        std::forward<Observer>(observer)(state, start_time);
+        // Run the action of the event.
+        EventAction action = EventAction::Continue;
+        index              = 0;
+        const auto act     = [&](auto &event) {
+            if (index++ == triggered) {
+                action = event.action(state, start_time);
+            }
+        };
+        (act(events), ...);
+        if (action == EventAction::Terminate) {
+            break;
+        }
+        // Restart the detection from the state left by the action.
+        before = {static_cast<value_type>(events.function(state, start_time))...};
+    }
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+/// @brief Integrates the system through a schedule of breakpoints, such as
+/// mode or parameter changes, landing exactly on each one of them.
+///
+/// @details This replaces calling `integrate_adaptive` once per segment: the
+/// stepper is sized once, and the step size learned by an adaptive stepper
+/// carries over from one segment to the next, instead of restarting from
+/// `time_delta`. Each segment ends exactly on its breakpoint: the last step
+/// can be stretched by 1%, and with adaptive steppers, when the remaining time
+/// is between one and two steps it is split into two equal steps, to avoid a
+/// final sliver step. The steps shortened to land on a breakpoint can only
+/// reduce the learned step size.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam Schedule A range of breakpoints sorted by time, each exposing a
+/// `time` member, e.g., `Breakpoint`.
+/// @tparam Update The type of the function applying a breakpoint.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration, later breakpoints are ignored.
+/// @param time_delta The initial step size for integration.
+/// @param schedule The breakpoints, the ones before the start time are applied immediately.
+/// @param update Function called as `update(breakpoint, state)` when the
+/// integration reaches a breakpoint, before integrating past it.
+///
+/// @return The number of steps taken to complete the integration.
+template <class Stepper, class System, class Observer, class Schedule, class Update>
+constexpr auto integrate_schedule(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const Schedule &schedule,
+    Update &&update)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+
+    // Adjust the stepper's internal size once, for all the segments.
+    if constexpr (numint::detail::has_resize_v<state_type>) {
+        stepper.adjust_size(state);
+    }
+    // Call the observer at the beginning.
+    std::forward<Observer>(observer)(state, start_time);
+    detail::integrate_schedule_from(
+        stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, end_time,
+        time_delta, std::begin(schedule), std::end(schedule), std::forward<Update>(update),
+        [](const state_type &, time_type, time_type, auto) {});
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+/// @brief Saves a checkpoint of the integration to a file, from which
+/// `load_checkpoint` restores it.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param path The path of the file, which is replaced atomically.
+/// @param stepper The stepper, whose internal state is saved.
+/// @param state The current state of the system.
+/// @param time The current time.
+/// @param time_delta The size of the next step.
+template <class Stepper>
+void save_checkpoint(
+    const std::string &path,
+    const Stepper &stepper,
+    const typename Stepper::state_type &state,
+    typename Stepper::time_type time,
+    typename Stepper::time_type time_delta)
+{
+    detail::checkpoint_writer writer;
+    // Describe the types, to reject a checkpoint saved by another program.
+    writer.write(static_cast<std::uint32_t>(sizeof(typename Stepper::time_type)));
+    writer.write(static_cast<std::uint32_t>(sizeof(typename Stepper::value_type)));
+    writer.write(static_cast<std::uint32_t>(Stepper::is_adaptive_stepper));
+    writer.write(time);
+    writer.write(time_delta);
+    writer.write_state(state);
+    stepper.save(writer);
+    writer.save(path);
+}
+
+/// @brief Restores the integration from a checkpoint saved by `save_checkpoint`.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param path The path of the file.
+/// @param stepper The stepper, whose internal state is restored.
+/// @param state The state of the system, restored, and resized to the
+/// dimension of the checkpoint if it can be, along with the stepper.
+/// @param time The time, restored.
+/// @param time_delta The size of the next step, restored.
+///
+/// @return false if there is no checkpoint, in which case nothing changes.
+template <class Stepper>
+auto load_checkpoint(
+    const std::string &path,
+    Stepper &stepper,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type &time,
+    typename Stepper::time_type &time_delta) -> bool
+{
+    detail::checkpoint_reader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    std::uint32_t time_size = 0, value_size = 0, adaptive = 0;
+    reader.read(time_size);
+    reader.read(value_size);
+    reader.read(adaptive);
+    if ((time_size != sizeof(typename Stepper::time_type)) ||
+        (value_size != sizeof(typename Stepper::value_type)) ||
+        (adaptive != static_cast<std::uint32_t>(Stepper::is_adaptive_stepper))) {
+        throw std::runtime_error("The checkpoint `" + path + "` was saved by a different stepper.");
+    }
+    reader.read(time);
+    reader.read(time_delta);
+    reader.read_state(state);
+    // The state takes the dimension of the checkpoint, so the stepper must follow.
+    if constexpr (numint::detail::has_resize_v<typename Stepper::state_type>) {
+        stepper.adjust_size(state);
+    }
+    stepper.load(reader);
+    return true;
+}
+
+/// @brief Integrates the system from the start time to the end time, saving a
+/// checkpoint periodically, and resuming from it if present.
+///
+/// @details When the checkpoint file exists, the stepper, the state, the time
+/// and the step size are restored from it, and the integration continues
+/// where it was interrupted (e.g., by a job scheduler), giving the same
+/// results, bit by bit, as an uninterrupted run. A new checkpoint is saved
+/// after the first step that ends at least `interval` after the previous
+/// one, in wall-clock time, and the file is removed once the integration
+/// completes. Adaptive steppers are driven as in `integrate_adaptive`, fixed
+/// ones as in `integrate_fixed`. After resuming, the observer is not called
+/// again on the restored state.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam Rep The arithmetic type of the interval.
+/// @tparam Period The unit of the interval.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The (initial) step size for integration.
+/// @param path The path of the checkpoint file.
+/// @param interval The wall-clock time between two checkpoints.
+///
+/// @return The number of steps taken to complete the integration, including
+/// the ones taken before the checkpoint.
+template <class Stepper, class System, class Observer, class Rep, class Period>
+auto integrate_checkpointed(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const std::string &path,
+    std::chrono::duration<Rep, Period> interval)
+{
+    using state_type = typename Stepper::state_type;
+    using clock_type = std::chrono::steady_clock;
+
+    // Adjust the stepper's internal size if the state supports resizing.
+    if constexpr (numint::detail::has_resize_v<state_type>) {
+        stepper.adjust_size(state);
+    }
+    // Resume from the checkpoint, if any.
+    const bool resumed = load_checkpoint(path, stepper, state, start_time, time_delta);
+    // Saves a checkpoint when the interval elapsed.
+    auto last_save         = clock_type::now();
+    const auto save_if_due = [&]() {
+        const auto now = clock_type::now();
+        if ((now - last_save) >= interval) {
+            save_checkpoint(path, stepper, state, start_time, time_delta);
+            last_save = now;
+        }
+    };
+    if constexpr (Stepper::is_adaptive_stepper) {
+        // Same loop as `integrate_adaptive`.
+        while (numint::detail::less_with_sign(start_time, end_time, time_delta)) {
+            while (numint::detail::less_eq_with_sign(start_time + time_delta, end_time, time_delta)) {
+                detail::integrate_one_step(
+                    stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time,
+                    time_delta);
+                start_time += time_delta;
+                time_delta = stepper.get_time_delta();
+                save_if_due();
+            }
+            time_delta = end_time - start_time;
+        }
+        std::forward<Observer>(observer)(state, start_time);
+    } else {
+        // Same loop as `integrate_fixed`.
+        if (!resumed) {
+            std::forward<Observer>(observer)(state, start_time);
+        }
+        while (start_time < end_time) {
+            detail::integrate_one_step(
+                stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, time_delta);
+            start_time += time_delta;
+            save_if_due();
+        }
+    }
+    // The integration is over, there is nothing left to resume.
+    std::remove(path.c_str());
     // Return the number of steps it took to integrate.
     return stepper.steps();
 }
@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include "numint/detail/checkpoint.hpp"
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/statistics.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 #include <cmath>
@@ -42,13 +45,15 @@ public:
     using state_type                          = typename Stepper::state_type;
     /// @brief Type of value contained in the state vector.
     using value_type                          = typename Stepper::state_type::value_type;
+    /// @brief Scalar type of the truncation error, the lanes of a batched
+    /// state share the same step-size, driven by the worst lane.
+    using error_type                          = detail::scalar_type_t<value_type>;
     /// @brief Determines if this is an adaptive stepper or not.
     static constexpr bool is_adaptive_stepper = true;
 
     /// @brief Creates a new adaptive stepper.
     stepper_adaptive()
-        : m_stepper_main()
-        , m_stepper_tuner()
+        : m_stepper()
         , m_tollerance(0.0001)
         , m_time_delta(1e-12)
         , m_min_delta(1e-12)
@@ -85,21 +90,21 @@ public:
     /// @brief Sets the tolerance for step-size control.
     ///
     /// @param tollerance The tolerance value to use for adjusting the step size.
-    constexpr void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+    constexpr void set_tollerance(error_type tollerance) { m_tollerance = tollerance; }
 
     /// @brief Sets the minimum allowed step size.
     ///
     /// @param min_delta The minimum step size.
-    constexpr void set_min_delta(value_type min_delta) { m_min_delta = min_delta; }
+    constexpr void set_min_delta(time_type min_delta) { m_min_delta = min_delta; }
 
     /// @brief Sets the maximum allowed step size.
     ///
     /// @param max_delta The maximum step size.
-    constexpr void set_max_delta(value_type max_delta) { m_max_delta = max_delta; }
+    constexpr void set_max_delta(time_type max_delta) { m_max_delta = max_delta; }
 
     /// @brief The order of the stepper we rely upon.
     /// @return the order of the internal stepper.
-    constexpr auto order_step() const -> order_type { return m_stepper_main.order_step(); }
+    constexpr auto order_step() const -> order_type { return m_stepper.order_step(); }
 
     /// @brief Retrieves the current adaptive step size.
     /// @return The current step size as a `time_type` value.
@@ -109,14 +114,83 @@ public:
     /// @param reference a reference state vector vector.
     void adjust_size(const state_type &reference)
     {
-        m_stepper_main.adjust_size(reference);
-        m_stepper_tuner.adjust_size(reference);
+        m_stepper.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_y.resize(reference.size());
+        }
     }
 
     /// @brief Returns the number of steps the stepper executed up until now.
     /// @return the number of integration steps.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves the state of the stepper into a checkpoint: the step size
+    /// learned so far, the last truncation errors, the settings, and the steps.
+    /// @param writer The checkpoint being written.
+    void save(detail::checkpoint_writer &writer) const
+    {
+        m_stepper.save(writer);
+        writer.write(m_tollerance);
+        writer.write(m_time_delta);
+        writer.write(m_min_delta);
+        writer.write(m_max_delta);
+        writer.write(m_t_err);
+        writer.write(m_t_err_abs);
+        writer.write(m_t_err_rel);
+        writer.write(m_steps);
+#ifdef NUMINT_STATISTICS
+        writer.write(m_stats);
+#endif
+    }
+
+    /// @brief Saves only the settings of the stepper: the tolerance, the
+    /// bounds of the step size, the iterations, and the error formula. Unlike
+    /// `save`, two steppers configured alike write the same bytes, whatever
+    /// they integrated before.
+    /// @param writer The checkpoint being written.
+    void save_settings(detail::checkpoint_writer &writer) const
+    {
+        writer.write(m_tollerance);
+        writer.write(m_min_delta);
+        writer.write(m_max_delta);
+        writer.write(static_cast<std::int32_t>(Iterations));
+        writer.write(static_cast<std::uint8_t>(Error));
+    }
+
+    /// @brief Restores the state of the stepper from a checkpoint.
+    /// @param reader The checkpoint being read.
+    void load(detail::checkpoint_reader &reader)
+    {
+        m_stepper.load(reader);
+        reader.read(m_tollerance);
+        reader.read(m_time_delta);
+        reader.read(m_min_delta);
+        reader.read(m_max_delta);
+        reader.read(m_t_err);
+        reader.read(m_t_err_abs);
+        reader.read(m_t_err_rel);
+        reader.read(m_steps);
+#ifdef NUMINT_STATISTICS
+        reader.read(m_stats);
+#endif
+    }
+
+    /// @brief Returns the statistics of the integration, which are collected
+    /// only when `NUMINT_STATISTICS` is defined. The evaluations of the system
+    /// are the ones of both the full step and the tuning ones. Every step is
+    /// accepted, as the controller only adapts the size of the next one.
+    /// @return The statistics.
+    auto stats() const -> detail::Statistics
+    {
+#ifdef NUMINT_STATISTICS
+        detail::Statistics stats = m_stats;
+        stats.rhs_evaluations    = m_stepper.stats().rhs_evaluations;
+        return stats;
+#else
+        return detail::Statistics();
+#endif
+    }
+
     /// @brief Performs one integration step using the provided system.
     ///
     /// @details This function advances the state of the system by one step
@@ -142,37 +216,40 @@ public:
         using detail::it_algebra::max_comb_diff;
         using detail::it_algebra::max_rel_diff;
 
+        NUMINT_TRACE_BEGIN(step);
         // Copy the step size.
         m_time_delta = dt;
-        // Copy the initial state.
-        state_type y(x);
-        // Compute values of (0).
-        m_stepper_main.do_step(std::forward<System>(system), y, t, m_time_delta);
+        // Compute values of (0), writing them aside, so that the initial state
+        // does not need to be copied first.
+        detail::set_system_role(system, "main");
+        m_stepper.do_step(std::forward<System>(system), x, m_y, t, m_time_delta);
         // Compute values of (1).
+        detail::set_system_role(system, "tuner");
         if constexpr (Iterations <= 2) {
             const time_type dh = m_time_delta * .5;
-            m_stepper_tuner.do_step(std::forward<System>(system), x, t + dh, dh);
-            m_stepper_tuner.do_step(std::forward<System>(system), x, t + m_time_delta, dh);
+            m_stepper.do_step(std::forward<System>(system), x, t, dh);
+            m_stepper.do_step(std::forward<System>(system), x, t + dh, dh);
         } else {
             const time_type dh = m_time_delta * (1. / Iterations);
             for (unsigned i = 0; i < Iterations; ++i) {
-                m_stepper_tuner.do_step(std::forward<System>(system), x, t + (dh * i), dh);
+                m_stepper.do_step(std::forward<System>(system), x, t + (dh * i), dh);
             }
         }
+        detail::set_system_role(system, nullptr);
         // Calculate truncation error.
         if constexpr (Error == ErrorFormula::Absolute) {
             // Get absolute truncation error.
-            m_t_err_abs = max_abs_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
+            m_t_err_abs = max_abs_diff<error_type>(x, m_y);
             // Update the time-delta.
             m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err_abs), 0.2), 0.3), 2.);
         } else if constexpr (Error == ErrorFormula::Relative) {
             // Get relative truncation error.
-            m_t_err_rel = max_rel_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
+            m_t_err_rel = max_rel_diff<error_type>(x, m_y);
             // Update the time-delta.
             m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err_rel), 0.2), 0.3), 2.);
         } else {
             // Get mixed truncation error.
-            m_t_err = max_comb_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
+            m_t_err = max_comb_diff<error_type>(x, m_y);
             // Update the time-delta.
             m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err), 0.2), 0.3), 2.);
         }
@@ -180,66 +257,22 @@ public:
         m_time_delta = std::min(std::max(m_time_delta, m_min_delta), m_max_delta);
         // Increase the number of steps.
         ++m_steps;
-
-        /*
-        // Copy the step size.
-        m_time_delta = dt;
-        // Copy the initial state.
-        state_type y0, y1;
-        while (true) {
-            y0 = x, y1 = x;
-
-            // Compute values of (0).
-            m_stepper_main.do_step(std::forward<System>(system), y0, t, m_time_delta);
-
-            // Compute values of (1).
-            if constexpr (Iterations <= 2) {
-                const time_type dh = m_time_delta * .5;
-                m_stepper_tuner.do_step(std::forward<System>(system), y1, t + dh, dh);
-                m_stepper_tuner.do_step(std::forward<System>(system), y1, t + m_time_delta, dh);
-            } else {
-                const time_type dh = m_time_delta * (1. / Iterations);
-                for (unsigned i = 0; i < Iterations; ++i) {
-                    m_stepper_tuner.do_step(std::forward<System>(system), y1, t + dh * i, dh);
-                }
-            }
-
-            // Calculate truncation error.
-            if constexpr (Error == ErrorFormula::Absolute) {
-                // Get absolute truncation error.
-                m_t_err = max_abs_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
-            } else if constexpr (Error == ErrorFormula::Relative) {
-                // Get relative truncation error.
-                m_t_err = max_rel_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
-            } else {
-                // Get mixed truncation error.
-                m_t_err = max_comb_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
-            }
-
-            // Update the time-delta.
-            m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err), 0.2), 0.3), 2.);
-            // Check boundaries.
-            m_time_delta = std::min(std::max(m_time_delta, m_min_delta), m_max_delta);
-
-            // Increase the number of steps.
-            ++m_steps;
-
-            // Check if error is within tolerance
-            if (m_t_err <= m_tollerance) {
-                std::cout << m_t_err << "\n";
-                // Update the state.
-                x = y1;
-                break;
-            }
-        }
-        */
+#ifdef NUMINT_STATISTICS
+        // Record the step, the evaluations are counted by the internal steppers.
+        m_stats.accept(static_cast<double>(dt), 0);
+#endif
+        // The step is always accepted, the controller only adapts the next one.
+        NUMINT_TRACE_INSTANT("accept", dt);
+        NUMINT_TRACE_END(step, "stepper_adaptive::do_step");
     }
 
 private:
-    /// The main stepper.
-    stepper_type m_stepper_main;
-    /// A temporary stepper we use to tune the main stepper.
-    stepper_type m_stepper_tuner;
+    /// The stepper taking both the full step and the tuning ones: it keeps
+    /// nothing from one step to the next but its counters, hence they can
+    /// share its workspace.
+    stepper_type m_stepper;
+    /// The state computed by the main stepper.
+    state_type m_y;
     /// The tollerance value we use to tune the step-size.
     time_type m_tollerance;
     /// A copy of the step-size.
@@ -249,13 +282,17 @@ private:
     /// The maximum step-size.
     time_type m_max_delta;
     /// Holds the error between the main stepper and the temporary stepper.
-    value_type m_t_err;
+    error_type m_t_err;
     /// Holds the absolute error between the main stepper and the temporary stepper.
-    value_type m_t_err_abs;
+    error_type m_t_err_abs;
     /// Holds the relative error between the main stepper and the temporary stepper.
-    value_type m_t_err_rel;
+    error_type m_t_err_rel;
     /// The number of steps of integration.
     uint64_t m_steps{};
+#ifdef NUMINT_STATISTICS
+    /// The statistics of the integration.
+    detail::Statistics m_stats;
+#endif
 };
 
 } // namespace numint
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/step_counter.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 namespace numint
@@ -15,7 +17,7 @@ namespace numint
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
-class stepper_euler
+class stepper_euler : public detail::step_counter
 {
 public:
     /// @brief Type used for the order of the stepper.
@@ -70,10 +72,6 @@ public:
         }
     }
 
-    /// @brief Returns the number of steps executed by the stepper so far.
-    /// @return The number of integration steps executed.
-    constexpr auto steps() const { return m_steps; }
-
     /// @brief Performs a single integration step using Euler's method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system The system to integrate.
@@ -83,23 +81,36 @@ public:
     template <class System>
     void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
     {
+        this->do_step(std::forward<System>(system), x, x, t, dt);
+    }
+
+    /// @brief Performs a single integration step using Euler's method, writing
+    /// the result into a different state vector.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param in The initial state vector.
+    /// @param out The state vector receiving the result, it can be `in` itself.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, const state_type &in, state_type &out, const time_type t, const time_type dt)
+    {
+        NUMINT_TRACE_BEGIN(step);
         // Calculate the derivative at the current time.
-        std::forward<System>(system)(x, m_dxdt, t);
+        detail::call_system(std::forward<System>(system), in, m_dxdt, t, "euler.k1");
 
         // Update the state vector using Euler's method:
         //      x(t + dt) = x(t) + dxdt * dt.
-        detail::it_algebra::accumulate_operation(x.begin(), x.end(), std::multiplies<>(), dt, m_dxdt.begin());
+        detail::it_algebra::sum_operation(out, std::multiplies<>(), 1., in, dt, m_dxdt);
 
-        // Increment the number of integration steps.
-        ++m_steps;
+        // Count the step, which took 1 evaluation of the system.
+        this->count_step(dt, 1);
+        NUMINT_TRACE_END(step, "stepper_euler::do_step");
     }
 
 private:
     /// Keeps track of the derivative of the state.
     state_type m_dxdt;
-
-    /// The number of steps taken during integration.
-    unsigned long m_steps{};
 };
 
 } // namespace numint
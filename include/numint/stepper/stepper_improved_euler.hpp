@@ -6,6 +6,8 @@
 #pragma once
 
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/step_counter.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 namespace numint
@@ -16,7 +18,7 @@ namespace numint
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
-class stepper_improved_euler
+class stepper_improved_euler : public detail::step_counter
 {
 public:
     /// @brief Type used for the order of the stepper.
@@ -73,10 +75,6 @@ public:
         }
     }
 
-    /// @brief Returns the number of steps executed by the stepper so far.
-    /// @return The number of integration steps executed.
-    constexpr auto steps() const { return m_steps; }
-
     /// @brief Performs a single integration step using Heun's method (Improved Euler method).
     /// @param system The system to integrate.
     /// @param x The initial state vector.
@@ -85,26 +83,40 @@ public:
     template <class System>
     constexpr void do_step(System &&system, state_type &x, const time_type t, const time_type dt) noexcept
     {
+        this->do_step(std::forward<System>(system), x, x, t, dt);
+    }
+
+    /// @brief Performs a single integration step using Heun's method, writing
+    /// the result into a different state vector.
+    /// @param system The system to integrate.
+    /// @param in The initial state vector.
+    /// @param out The state vector receiving the result, it can be `in` itself.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    constexpr void
+    do_step(System &&system, const state_type &in, state_type &out, const time_type t, const time_type dt) noexcept
+    {
+        NUMINT_TRACE_BEGIN(step);
         // Calculate the derivative at the initial point:
         //      dxdt1 = system(x, t);
-        std::forward<System>(system)(x, m_dxdt1, t);
+        detail::call_system(std::forward<System>(system), in, m_dxdt1, t, "improved_euler.k1");
 
         // Calculate the state at the next time point using Euler's method:
         //      m_x(t + dt) = x(t) + dxdt1 * dt;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1., x.begin(), dt, m_dxdt1.begin());
+        detail::it_algebra::sum_operation(m_x, std::multiplies<>(), 1., in, dt, m_dxdt1);
 
         // Calculate the derivative at the midpoint:
         //      dxdt2 = system(m_x, t + dt);
-        std::forward<System>(system)(m_x, m_dxdt2, t + dt);
+        detail::call_system(std::forward<System>(system), m_x, m_dxdt2, t + dt, "improved_euler.k2");
 
         // Update the state vector using the average of the derivatives:
         //      x(t + dt) = x(t) + (dt / 2) * (dxdt1 + dxdt2);
-        detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), dt * .5, m_dxdt1.begin(), dt * .5, m_dxdt2.begin());
+        detail::it_algebra::sum_operation(out, std::multiplies<>(), 1., in, dt * .5, m_dxdt1, dt * .5, m_dxdt2);
 
-        // Increment the number of integration steps.
-        ++m_steps;
+        // Count the step, which took 2 evaluations of the system.
+        this->count_step(dt, 2);
+        NUMINT_TRACE_END(step, "stepper_improved_euler::do_step");
     }
 
 private:
@@ -116,9 +128,6 @@ private:
 
     /// Temporary state vector for intermediate calculations.
     state_type m_x;
-
-    /// The number of steps taken during integration.
-    unsigned long m_steps{};
 };
 
 } // namespace numint
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/step_counter.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 namespace numint
@@ -15,7 +17,7 @@ namespace numint
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
-class stepper_rk4
+class stepper_rk4 : public detail::step_counter
 {
 public:
     /// @brief Type used for the order of the stepper.
@@ -74,10 +76,6 @@ public:
         }
     }
 
-    /// @brief Returns the number of steps executed by the stepper so far.
-    /// @return The number of integration steps executed.
-    constexpr auto steps() const { return m_steps; }
-
     /// @brief Performs a single integration step using the fourth-order Runge-Kutta method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system The system to integrate.
@@ -87,6 +85,22 @@ public:
     template <class System>
     constexpr void do_step(System &&system, state_type &x, const time_type t, const time_type dt) noexcept
     {
+        this->do_step(std::forward<System>(system), x, x, t, dt);
+    }
+
+    /// @brief Performs a single integration step using the fourth-order
+    /// Runge-Kutta method, writing the result into a different state vector.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param in The initial state vector.
+    /// @param out The state vector receiving the result, it can be `in` itself.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    constexpr void
+    do_step(System &&system, const state_type &in, state_type &out, const time_type t, const time_type dt) noexcept
+    {
+        NUMINT_TRACE_BEGIN(step);
         // Here is the idea:
         //  - m_dxdt1 : Slope at the beginning of the interval
         //  - m_dxdt2 : Slope at the midpoint of the interval
@@ -95,51 +109,46 @@ public:
 
         // Step 1: Calculate the slope at the beginning of the interval (m_dxdt1):
         //      m_dxdt1 = f(x, t);
-        std::forward<System>(system)(x, m_dxdt1, t);
+        detail::call_system(std::forward<System>(system), in, m_dxdt1, t, "rk4.k1");
 
         // Update temporary state using the slope at the beginning and move halfway forward:
         //      m_x(t + dt * 0.5) = x(t) + m_dxdt1 * dt * 0.5;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), 0.5 * dt, m_dxdt1.begin());
+        detail::it_algebra::sum_operation(m_x, std::multiplies<>(), 1.0, in, 0.5 * dt, m_dxdt1);
 
         // Step 2: Calculate the slope at the midpoint of the interval (m_dxdt2):
         //      m_dxdt2 = f(m_x, t + 0.5 * dt);
-        std::forward<System>(system)(m_x, m_dxdt2, t + (0.5 * dt));
+        detail::call_system(std::forward<System>(system), m_x, m_dxdt2, t + (0.5 * dt), "rk4.k2");
 
         // Update temporary state using the slope at the midpoint and move halfway forward again:
         //      m_x(t + dt * 0.5) = x(t) + m_dxdt2 * dt * 0.5;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), 0.5 * dt, m_dxdt2.begin());
+        detail::it_algebra::sum_operation(m_x, std::multiplies<>(), 1.0, in, 0.5 * dt, m_dxdt2);
 
         // Step 3: Calculate another slope at the midpoint of the interval (m_dxdt3):
         //      m_dxdt3 = f(m_x, t + 0.5 * dt);
-        std::forward<System>(system)(m_x, m_dxdt3, t + (0.5 * dt));
+        detail::call_system(std::forward<System>(system), m_x, m_dxdt3, t + (0.5 * dt), "rk4.k3");
 
         // Update temporary state using the slope at the midpoint and move to the end of the interval:
         //      m_x(t + dt) = x(t) + m_dxdt3 * dt;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), dt, m_dxdt3.begin());
+        detail::it_algebra::sum_operation(m_x, std::multiplies<>(), 1.0, in, dt, m_dxdt3);
 
         // Step 4: Calculate the slope at the end of the interval (m_dxdt4):
         //      m_dxdt4 = f(m_x, t + dt);
-        std::forward<System>(system)(m_x, m_dxdt4, t + dt);
+        detail::call_system(std::forward<System>(system), m_x, m_dxdt4, t + dt, "rk4.k4");
 
         // Update each component of the state vector using the weighted average
         // of the slopes: m_dxdt1, m_dxdt2, m_dxdt3, and m_dxdt4.
-        detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), dt * (1. / 6.), m_dxdt1.begin(), dt * (2. / 6.), m_dxdt2.begin(),
-            dt * (2. / 6.), m_dxdt3.begin(), dt * (1. / 6.), m_dxdt4.begin());
+        detail::it_algebra::sum_operation(
+            out, std::multiplies<>(), 1.0, in, dt * (1. / 6.), m_dxdt1, dt * (2. / 6.), m_dxdt2, dt * (2. / 6.),
+            m_dxdt3, dt * (1. / 6.), m_dxdt4);
 
-        // Increase the number of steps.
-        ++m_steps;
+        // Count the step, which took 4 evaluations of the system.
+        this->count_step(dt, 4);
+        NUMINT_TRACE_END(step, "stepper_rk4::do_step");
     }
 
 private:
     /// Support vectors for the slopes.
     state_type m_dxdt1, m_dxdt2, m_dxdt3, m_dxdt4, m_x;
-
-    /// The number of steps of integration.
-    unsigned long m_steps{};
 };
 
 } // namespace numint
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/step_counter.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 namespace numint
@@ -15,7 +17,7 @@ namespace numint
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
-class stepper_simpsons
+class stepper_simpsons : public detail::step_counter
 {
 public:
     /// @brief Type used for the order of the stepper.
@@ -68,10 +70,6 @@ public:
         }
     }
 
-    /// @brief Returns the number of steps the stepper executed up until now.
-    /// @return the number of integration steps.
-    constexpr auto steps() const { return m_steps; }
-
     /// @brief Perform a single integration step using Euler's method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system the system we are integrating.
@@ -81,34 +79,48 @@ public:
     template <class System>
     void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
     {
+        this->do_step(std::forward<System>(system), x, x, t, dt);
+    }
+
+    /// @brief Perform a single integration step using Simpson's rule, writing
+    /// the result into a different state vector.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system the system we are integrating.
+    /// @param in the initial state.
+    /// @param out the state receiving the result, it can be `in` itself.
+    /// @param t the initial time.
+    /// @param dt the step-size.
+    template <class System>
+    void do_step(System &&system, const state_type &in, state_type &out, const time_type t, const time_type dt)
+    {
+        NUMINT_TRACE_BEGIN(step);
         // Calculate the derivative at the start point.
         //
-        std::forward<System>(system)(x, m_dxdt_start, t);
+        detail::call_system(std::forward<System>(system), in, m_dxdt_start, t, "simpsons.k1");
 
         // Calculate the derivative at the midpoint.
         //
-        std::forward<System>(system)(x, m_dxdt_midpoint, t + (dt * 0.5));
+        detail::call_system(std::forward<System>(system), in, m_dxdt_midpoint, t + (dt * 0.5), "simpsons.k2");
 
         // Calculate the derivative at the end point.
         //
-        std::forward<System>(system)(x, m_dxdt_end, t + dt);
+        detail::call_system(std::forward<System>(system), in, m_dxdt_end, t + dt, "simpsons.k3");
 
         // Update the state vector using Euler's method:
         //      x(t + dt) = x(t) + (dt / 6) * dxdt_start + dt * (4 / 6) * dxdt_mid + (dt / 6) * dxdt_end
         //
-        detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), (dt / 6.0), m_dxdt_start.begin(), (dt / 6.0) * 4.0,
-            m_dxdt_midpoint.begin(), (dt / 6.0), m_dxdt_end.begin());
+        detail::it_algebra::sum_operation(
+            out, std::multiplies<>(), 1., in, (dt / 6.0), m_dxdt_start, (dt / 6.0) * 4.0, m_dxdt_midpoint, (dt / 6.0),
+            m_dxdt_end);
 
-        // Increment the number of integration steps.
-        ++m_steps;
+        // Count the step, which took 3 evaluations of the system.
+        this->count_step(dt, 3);
+        NUMINT_TRACE_END(step, "stepper_simpsons::do_step");
     }
 
 private:
     /// Keeps track of state evolution.
     state_type m_dxdt_start, m_dxdt_midpoint, m_dxdt_end;
-    /// The number of steps of integration.
-    unsigned long m_steps{};
 };
 
 } // namespace numint
\ No newline at end of file
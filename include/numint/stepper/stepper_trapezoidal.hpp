@@ -6,6 +6,8 @@
 #pragma once
 
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/step_counter.hpp"
+#include "numint/detail/trace.hpp"
 #include "numint/detail/type_traits.hpp"
 
 namespace numint
@@ -16,7 +18,7 @@ namespace numint
 /// @tparam State The state vector type.
 /// @tparam Time The datatype used to hold time.
 template <class State, class Time>
-class stepper_trapezoidal
+class stepper_trapezoidal : public detail::step_counter
 {
 public:
     /// @brief Type used for the order of the stepper.
@@ -68,10 +70,6 @@ public:
         }
     }
 
-    /// @brief Returns the number of steps the stepper executed up until now.
-    /// @return the number of integration steps.
-    constexpr auto steps() const { return m_steps; }
-
     /// @brief Perform a single integration step using Euler's method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system the system we are integrating.
@@ -81,28 +79,42 @@ public:
     template <class System>
     void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
     {
+        this->do_step(std::forward<System>(system), x, x, t, dt);
+    }
+
+    /// @brief Perform a single integration step using the trapezoidal rule,
+    /// writing the result into a different state vector.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system the system we are integrating.
+    /// @param in the initial state.
+    /// @param out the state receiving the result, it can be `in` itself.
+    /// @param t the initial time.
+    /// @param dt the step-size.
+    template <class System>
+    void do_step(System &&system, const state_type &in, state_type &out, const time_type t, const time_type dt)
+    {
+        NUMINT_TRACE_BEGIN(step);
         // Calculate the derivative at the start point.
         //
-        std::forward<System>(system)(x, m_dxdt_start, t);
+        detail::call_system(std::forward<System>(system), in, m_dxdt_start, t, "trapezoidal.k1");
 
         // Calculate the derivative at the end point.
         //
-        std::forward<System>(system)(x, m_dxdt_end, t + dt);
+        detail::call_system(std::forward<System>(system), in, m_dxdt_end, t + dt, "trapezoidal.k2");
 
         // Update the state vector using Euler's method:
         //      x(t + dt) = x(t) + (0.5 * dt * dxdt_start) + (0.5 * dt * dxdt_end)
-        detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), 0.5 * dt, m_dxdt_start.begin(), 0.5 * dt, m_dxdt_end.begin());
+        detail::it_algebra::sum_operation(
+            out, std::multiplies<>(), 1., in, 0.5 * dt, m_dxdt_start, 0.5 * dt, m_dxdt_end);
 
-        // Increment the number of integration steps.
-        ++m_steps;
+        // Count the step, which took 2 evaluations of the system.
+        this->count_step(dt, 2);
+        NUMINT_TRACE_END(step, "stepper_trapezoidal::do_step");
     }
 
 private:
     /// Keeps track of state evolution.
     state_type m_dxdt_start, m_dxdt_end;
-    /// The number of steps of integration.
-    unsigned long m_steps{};
 };
 
 } // namespace numint
\ No newline at end of file
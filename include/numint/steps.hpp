@@ -0,0 +1,263 @@
+/// @file steps.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Pull-based integration, where the caller owns the loop and takes the
+/// steps one at a time, instead of receiving them through an observer.
+
+#pragma once
+
+#include "numint/detail/landing_step.hpp"
+#include "numint/detail/type_traits.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief A step taken by a `step_range`.
+/// @tparam State The type of the state vector.
+/// @tparam Time The type used to keep track of time.
+template <class State, class Time>
+struct Step {
+    /// The state at the end of the step.
+    const State &state;
+    /// The time at the end of the step.
+    Time time;
+    /// The size of the step.
+    Time time_delta;
+};
+
+/// @brief A lazy range of integration steps, each one taken when the caller
+/// asks for it.
+///
+/// @details The range keeps the stepper, the system, the state and the time
+/// between the calls, so the caller can take a few steps, do something else
+/// (e.g., exchange data with other simulators), and continue from where it
+/// left off. Every step lands exactly on the time it is asked to reach, and
+/// adaptive steppers keep controlling the step size across the calls: the
+/// steps are the ones `integrate_schedule` takes between the same times (see
+/// `detail::landing_step`). Taking a step does not allocate.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system, a reference when the range does not
+/// own it.
+template <class Stepper, class System>
+class step_range
+{
+public:
+    /// @brief The state vector.
+    using state_type = typename Stepper::state_type;
+    /// @brief Type used to keep track of time.
+    using time_type  = typename Stepper::time_type;
+    /// @brief The type of the steps.
+    using step_type  = Step<state_type, time_type>;
+
+    /// @brief Input iterator over the steps, advancing it takes a step.
+    class iterator
+    {
+    public:
+        /// @brief The category of the iterator.
+        using iterator_category = std::input_iterator_tag;
+        /// @brief The type of the steps.
+        using value_type        = step_type;
+        /// @brief The type of the difference between iterators.
+        using difference_type   = std::ptrdiff_t;
+        /// @brief The type of the pointer to a step.
+        using pointer           = const step_type *;
+        /// @brief The steps are returned by value.
+        using reference         = step_type;
+
+        /// @brief Creates an end iterator.
+        iterator() = default;
+
+        /// @brief Creates an iterator over the given range.
+        /// @param range The range.
+        explicit iterator(step_range *range)
+            : m_range(range)
+        {
+            // Nothing to do.
+        }
+
+        /// @brief Returns the last step taken.
+        /// @return The last step taken.
+        auto operator*() const -> step_type { return m_range->last_step(); }
+
+        /// @brief Takes the next step, or becomes an end iterator.
+        /// @return Reference to this iterator.
+        auto operator++() -> iterator &
+        {
+            if (!m_range->next()) {
+                m_range = nullptr;
+            }
+            return *this;
+        }
+
+        /// @brief Takes the next step, or becomes an end iterator.
+        void operator++(int) { ++(*this); }
+
+        /// @brief Compares two iterators.
+        /// @param lhs The first iterator.
+        /// @param rhs The second iterator.
+        /// @return true if both are end iterators, or iterate the same range.
+        friend auto operator==(const iterator &lhs, const iterator &rhs) -> bool { return lhs.m_range == rhs.m_range; }
+
+        /// @brief Compares two iterators.
+        /// @param lhs The first iterator.
+        /// @param rhs The second iterator.
+        /// @return true if the iterators differ.
+        friend auto operator!=(const iterator &lhs, const iterator &rhs) -> bool { return !(lhs == rhs); }
+
+    private:
+        /// The range, null for the end iterator.
+        step_range *m_range = nullptr;
+    };
+
+    /// @brief Creates a new range of steps.
+    /// @param stepper The stepper used to perform the integration.
+    /// @param system The system being integrated.
+    /// @param state The initial state of the system, which will be updated at each step.
+    /// @param start_time The start time for the integration.
+    /// @param end_time The final time for the integration.
+    /// @param time_delta The (initial) step size for integration.
+    step_range(
+        Stepper &stepper,
+        System system,
+        state_type &state,
+        time_type start_time,
+        time_type end_time,
+        time_type time_delta)
+        : m_stepper(stepper)
+        , m_system(std::forward<System>(system))
+        , m_state(state)
+        , m_time(start_time)
+        , m_end_time(end_time)
+        , m_time_delta(time_delta)
+        , m_last_delta(0)
+    {
+        // Adjust the stepper's internal size if the state supports resizing.
+        if constexpr (numint::detail::has_resize_v<state_type>) {
+            m_stepper.adjust_size(m_state);
+        }
+    }
+
+    /// @brief Destructor.
+    ~step_range() = default;
+
+    /// @brief Copy constructor, deleted as the iterators point to the range.
+    step_range(const step_range &other) = delete;
+
+    /// @brief Move constructor, deleted as the iterators point to the range.
+    step_range(step_range &&other) = delete;
+
+    /// @brief Copy assignment operator, deleted as the iterators point to the range.
+    /// @return Reference to the range.
+    auto operator=(const step_range &other) -> step_range & = delete;
+
+    /// @brief Move assignment operator, deleted as the iterators point to the range.
+    /// @return Reference to the range.
+    auto operator=(step_range &&other) -> step_range & = delete;
+
+    /// @brief Takes the next step, and returns an iterator to it.
+    /// @return The iterator, or the end iterator if the range reached the end time.
+    auto begin() -> iterator { return this->next() ? iterator(this) : iterator(); }
+
+    /// @brief Returns the end iterator.
+    /// @return The end iterator.
+    auto end() -> iterator { return iterator(); }
+
+    /// @brief Returns the last step taken.
+    /// @return The last step taken.
+    auto last_step() const -> step_type { return step_type{m_state, m_time, m_last_delta}; }
+
+    /// @brief Returns the current time.
+    /// @return The current time.
+    auto time() const -> time_type { return m_time; }
+
+    /// @brief Checks if the range reached the end time.
+    /// @return true if there are no more steps to take.
+    auto done() const -> bool { return !(m_time < m_end_time); }
+
+    /// @brief Returns the statistics of the steps taken by the stepper, see
+    /// `detail::Statistics`.
+    /// @return The statistics.
+    auto stats() const { return m_stepper.stats(); }
+
+    /// @brief Takes one step towards the given time, without going beyond it.
+    /// @param stop The time to reach, the end time is never exceeded.
+    /// @return true if a step was taken, false if the time was already reached.
+    auto next(time_type stop) -> bool
+    {
+        stop = std::min(stop, m_end_time);
+        if (!(m_time < stop)) {
+            return false;
+        }
+        m_last_delta = detail::landing_step(m_stepper, m_system, m_state, m_time, m_time_delta, stop);
+        return true;
+    }
+
+    /// @brief Takes one step towards the end time.
+    /// @return true if a step was taken, false if the end time was already reached.
+    auto next() -> bool { return this->next(m_end_time); }
+
+    /// @brief Takes steps until the given time is reached, landing exactly on it.
+    /// @param stop The time to reach, the end time is never exceeded.
+    /// @return The number of steps taken.
+    auto advance_to(time_type stop) -> std::size_t
+    {
+        std::size_t count = 0;
+        while (this->next(stop)) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    /// The stepper used to perform the integration.
+    Stepper &m_stepper;
+    /// The system being integrated.
+    System m_system;
+    /// The state of the system.
+    state_type &m_state;
+    /// The current time.
+    time_type m_time;
+    /// The final time for the integration.
+    time_type m_end_time;
+    /// The size of the next step.
+    time_type m_time_delta;
+    /// The size of the last step taken.
+    time_type m_last_delta;
+};
+
+/// @brief Creates a lazy range of integration steps, see `step_range`.
+///
+/// @details The system is kept by reference when given as an lvalue, so it
+/// can be modified between the steps (e.g., to switch mode), and it is moved
+/// into the range otherwise. No step is taken until the caller asks for it.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated at each step.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The (initial) step size for integration.
+///
+/// @return The range of steps.
+template <class Stepper, class System>
+auto steps(
+    Stepper &stepper,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta) -> step_range<Stepper, System>
+{
+    return step_range<Stepper, System>(
+        stepper, std::forward<System>(system), state, start_time, end_time, time_delta);
+}
+
+} // namespace numint